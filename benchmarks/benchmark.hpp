@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace mcga::cli::bench {
+
+template<class T>
+inline void do_not_optimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Runs `fn` `iterations` times, repeated `repetitions` times, and returns the
+// fastest observed time per iteration, in nanoseconds.
+template<class Fn>
+double measure_ns(std::size_t iterations, Fn&& fn, int repetitions = 5) {
+  double best = std::numeric_limits<double>::max();
+  for (int rep = 0; rep < repetitions; ++rep) {
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+      fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::nano> elapsed = end - start;
+    best = std::min(best, elapsed.count() / static_cast<double>(iterations));
+  }
+  return best;
+}
+
+struct Result {
+  std::string name;
+  double ns_per_op;
+};
+
+// Every reported result, in the order the benchmarks ran.
+inline std::vector<Result>& results() {
+  static std::vector<Result> all_results;
+  return all_results;
+}
+
+// With --json, results are only printed at the end, see print_json.
+inline bool json_output = false;
+
+inline void report(const std::string& name, double ns_per_op) {
+  results().push_back({name, ns_per_op});
+  if (!json_output) {
+    std::printf("%-56s %10.2f ns/op\n", name.c_str(), ns_per_op);
+  }
+}
+
+// Prints the results as a JSON array of {"name", "ns_per_op"} objects, one
+// per line. Benchmark names never need escaping.
+inline void print_json() {
+  std::printf("[\n");
+  for (std::size_t i = 0; i < results().size(); ++i) {
+    const Result& result = results()[i];
+    std::printf("  {\"name\": \"%s\", \"ns_per_op\": %.2f}%s\n",
+                result.name.c_str(), result.ns_per_op,
+                i + 1 == results().size() ? "" : ",");
+  }
+  std::printf("]\n");
+}
+
+void run_option_index_benchmarks();
+
+void run_choice_benchmarks();
+
+void run_numeric_benchmarks();
+
+void run_list_benchmarks();
+
+void run_registration_benchmarks();
+
+void run_parse_benchmarks();
+
+void run_defaults_benchmarks();
+
+void run_help_benchmarks();
+
+} // namespace mcga::cli::bench
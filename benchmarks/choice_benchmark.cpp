@@ -0,0 +1,43 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#include <mcga/cli/choice_table.hpp>
+
+#include "benchmark.hpp"
+
+namespace mcga::cli::bench {
+
+// Per-value lookup cost of the frozen choice table, compared to the lookup in
+// the std::map of the spec it replaced (which needed a std::string key).
+void run_choice_benchmarks() {
+  for (std::size_t num_options: {10, 1000, 10000}) {
+    std::map<std::string, int> options;
+    std::vector<std::string> keys;
+    for (std::size_t i = 0; i < num_options; ++i) {
+      keys.push_back("model-name-" + std::to_string(i * 7919));
+      options[keys.back()] = static_cast<int>(i);
+    }
+    std::vector<std::string_view> tokens(keys.begin(), keys.end());
+    internal::ChoiceTable<int> table(options);
+
+    std::size_t iterations = 1000000 / num_options + 1;
+    double map_ns = measure_ns(iterations, [&] {
+      for (std::string_view token: tokens) {
+        do_not_optimize(options.find(std::string(token)));
+      }
+    });
+    double table_ns = measure_ns(iterations, [&] {
+      for (std::string_view token: tokens) {
+        do_not_optimize(table.find(token));
+      }
+    });
+    auto suffix = "/" + std::to_string(num_options) + "_options";
+    report("choice/std_map" + suffix,
+           map_ns / static_cast<double>(num_options));
+    report("choice/choice_table" + suffix,
+           table_ns / static_cast<double>(num_options));
+  }
+}
+
+} // namespace mcga::cli::bench
@@ -0,0 +1,59 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <mcga/cli.hpp>
+
+#include "benchmark.hpp"
+
+namespace mcga::cli::bench {
+
+// Cost per option of giving default values to options that do not appear in
+// the arguments: generated on every parse, generated only when read, or kept
+// across parses.
+void run_defaults_benchmarks() {
+  constexpr std::size_t num_options = 64;
+  constexpr std::size_t iterations = 20000;
+
+  auto make_parser = [&](std::vector<Argument>& arguments) {
+    auto parser = std::make_unique<Parser>("");
+    for (std::size_t i = 0; i < num_options; ++i) {
+      arguments.push_back(parser->add_argument(
+          ArgumentSpec("option-" + std::to_string(i))
+              .set_default_value_generator([i] {
+                return "default-" + std::to_string(i);
+              })));
+    }
+    return parser;
+  };
+  std::vector<std::string_view> no_args;
+  const auto count = static_cast<double>(num_options);
+
+  std::vector<Argument> eager_arguments;
+  auto eager_parser = make_parser(eager_arguments);
+  double eager_ns = measure_ns(iterations, [&] {
+    eager_parser->parse(no_args);
+    do_not_optimize(eager_arguments.back()->get_value_view().size());
+  });
+  report("defaults/generated", eager_ns / count);
+
+  std::vector<Argument> lazy_arguments;
+  auto lazy_parser = make_parser(lazy_arguments);
+  lazy_parser->enable_lazy_defaults();
+  double lazy_ns = measure_ns(iterations, [&] {
+    lazy_parser->parse(no_args);
+    do_not_optimize(lazy_arguments.back()->get_value_view().size());
+  });
+  report("defaults/lazy_one_read", lazy_ns / count);
+
+  std::vector<Argument> kept_arguments;
+  auto kept_parser = make_parser(kept_arguments);
+  kept_parser->keep_defaults_across_parses();
+  double kept_ns = measure_ns(iterations, [&] {
+    kept_parser->parse(no_args);
+    do_not_optimize(kept_arguments.back()->get_value_view().size());
+  });
+  report("defaults/kept_across_parses", kept_ns / count);
+}
+
+} // namespace mcga::cli::bench
@@ -0,0 +1,44 @@
+#include <string>
+
+#include <mcga/cli.hpp>
+
+#include "benchmark.hpp"
+
+namespace mcga::cli::bench {
+
+// Cost of rendering the help of a parser with 100 options in 5 groups, as a
+// table wrapped to the terminal width, and of reading it once cached.
+void run_help_benchmarks() {
+  Parser parser("Usage: bench [options] files...");
+  for (std::size_t i = 0; i < 100; ++i) {
+    parser.add_argument(
+        ArgumentSpec("option-" + std::to_string(i))
+            .set_help_group("Group " + std::to_string(i % 5))
+            .set_description("Sets the value of option number " +
+                             std::to_string(i) +
+                             ", which is described by a sentence long "
+                             "enough to be wrapped on narrow terminals.")
+            .set_default_value("value-" + std::to_string(i)));
+  }
+
+  // the table is cached for one width at a time, so alternating between two
+  // widths renders it on every call.
+  std::size_t width = 80;
+  double render_ns = measure_ns(1000, [&] {
+    width = width == 80 ? 81 : 80;
+    do_not_optimize(parser.render_help(width).size());
+  });
+  report("help/render_table/100_options", render_ns);
+
+  double cached_ns = measure_ns(1000000, [&] {
+    do_not_optimize(parser.render_help(80).size());
+  });
+  report("help/render_table_cached/100_options", cached_ns);
+
+  double legacy_ns = measure_ns(1000000, [&] {
+    do_not_optimize(parser.render_help().size());
+  });
+  report("help/render_cached/100_options", legacy_ns);
+}
+
+} // namespace mcga::cli::bench
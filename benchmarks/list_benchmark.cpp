@@ -0,0 +1,61 @@
+#include <string>
+#include <vector>
+
+#include <mcga/cli.hpp>
+
+#include "benchmark.hpp"
+
+namespace mcga::cli::bench {
+
+// Cost per element of filling a numeric list argument, from repeated flags
+// and from a single comma-separated value, and from repeated delimited flags
+// into a new parser, whose list grows from empty.
+void run_list_benchmarks() {
+  for (std::size_t num_values: {1000, 100000}) {
+    std::vector<std::string> flags;
+    std::string joined = "--ids=";
+    for (std::size_t i = 0; i < num_values; ++i) {
+      std::string id = std::to_string(i * 7919);
+      flags.push_back("--ids=" + id);
+      joined += (i == 0 ? "" : ",") + id;
+    }
+
+    Parser repeated_parser("");
+    auto repeated_ids = repeated_parser.add_list_argument(
+        ListArgumentSpec<NumericArgument<int>>("ids"));
+    Parser delimited_parser("");
+    auto delimited_ids = delimited_parser.add_list_argument(
+        ListArgumentSpec<NumericArgument<int>>("ids").set_delimiter(','));
+    std::vector<std::string> joined_args{joined};
+    std::vector<std::string> delimited_flags;
+    for (std::size_t i = 0; i + 1 < num_values; i += 2) {
+      delimited_flags.push_back(flags[i] + "," + flags[i + 1].substr(6));
+    }
+
+    std::size_t iterations = 2000000 / num_values + 1;
+    double repeated_ns = measure_ns(iterations, [&] {
+      repeated_parser.parse(flags);
+      do_not_optimize(repeated_ids->get_value().size());
+    });
+    double delimited_ns = measure_ns(iterations, [&] {
+      delimited_parser.parse(joined_args);
+      do_not_optimize(delimited_ids->get_value().size());
+    });
+    double growing_ns = measure_ns(iterations, [&] {
+      Parser parser("");
+      auto ids = parser.add_list_argument(
+          ListArgumentSpec<NumericArgument<int>>("ids").set_delimiter(','));
+      parser.parse(delimited_flags);
+      do_not_optimize(ids->get_value_view().size());
+    });
+    auto suffix = "/" + std::to_string(num_values) + "_values";
+    report("list/repeated_flags" + suffix,
+           repeated_ns / static_cast<double>(num_values));
+    report("list/delimited" + suffix,
+           delimited_ns / static_cast<double>(num_values));
+    report("list/repeated_delimited_flags/new_parser" + suffix,
+           growing_ns / static_cast<double>(num_values));
+  }
+}
+
+} // namespace mcga::cli::bench
@@ -0,0 +1,24 @@
+#include <cstring>
+
+#include "benchmark.hpp"
+
+// Pass --json to print the results as JSON, for comparing runs.
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--json") == 0) {
+      mcga::cli::bench::json_output = true;
+    }
+  }
+  mcga::cli::bench::run_option_index_benchmarks();
+  mcga::cli::bench::run_choice_benchmarks();
+  mcga::cli::bench::run_numeric_benchmarks();
+  mcga::cli::bench::run_list_benchmarks();
+  mcga::cli::bench::run_registration_benchmarks();
+  mcga::cli::bench::run_parse_benchmarks();
+  mcga::cli::bench::run_defaults_benchmarks();
+  mcga::cli::bench::run_help_benchmarks();
+  if (mcga::cli::bench::json_output) {
+    mcga::cli::bench::print_json();
+  }
+  return 0;
+}
@@ -0,0 +1,72 @@
+#include <string>
+#include <vector>
+
+#include <mcga/cli/numeric_argument.hpp>
+
+#include "benchmark.hpp"
+
+namespace mcga::cli::bench {
+
+// Conversion cost of the values of numeric arguments, compared to the
+// std::sto* functions they were converted with before.
+void run_numeric_benchmarks() {
+  const std::vector<std::string> values{
+      "0", "7", "42", "1337", "-250", "65535", "1000000", "-31415926",
+  };
+  std::vector<std::string_view> views(values.begin(), values.end());
+  const auto count = static_cast<double>(values.size());
+  constexpr std::size_t iterations = 200000;
+
+  double stoi_ns = measure_ns(iterations, [&] {
+    for (const std::string& value: values) {
+      do_not_optimize(std::stoi(value));
+    }
+  });
+  double from_string_ns = measure_ns(iterations, [&] {
+    for (std::string_view value: views) {
+      do_not_optimize(internal::from_string<int>(value));
+    }
+  });
+  report("int/std_stoi", stoi_ns / count);
+  report("int/from_string", from_string_ns / count);
+
+  const std::vector<std::string> long_values{
+      "9223372036854775807", "-9223372036854775808", "123456789012", "0xFF_FF",
+  };
+  std::vector<std::string_view> long_views(long_values.begin(),
+                                           long_values.end());
+  const auto long_count = static_cast<double>(long_values.size());
+  double stoll_ns = measure_ns(iterations, [&] {
+    for (const std::string& value: long_values) {
+      do_not_optimize(std::stoll(value, nullptr, 0));
+    }
+  });
+  double long_from_string_ns = measure_ns(iterations, [&] {
+    for (std::string_view value: long_views) {
+      do_not_optimize(internal::from_string<long long>(value));
+    }
+  });
+  report("long_long/std_stoll", stoll_ns / long_count);
+  report("long_long/from_string", long_from_string_ns / long_count);
+
+  const std::vector<std::string> double_values{
+      "0.5", "3.14159", "-2.5e-3", "1e10", "123456.789012345678", "0x1.8p3",
+  };
+  std::vector<std::string_view> double_views(double_values.begin(),
+                                             double_values.end());
+  const auto double_count = static_cast<double>(double_values.size());
+  double stod_ns = measure_ns(iterations, [&] {
+    for (const std::string& value: double_values) {
+      do_not_optimize(std::stod(value));
+    }
+  });
+  double double_from_string_ns = measure_ns(iterations, [&] {
+    for (std::string_view value: double_views) {
+      do_not_optimize(internal::from_string<double>(value));
+    }
+  });
+  report("double/std_stod", stod_ns / double_count);
+  report("double/from_string", double_from_string_ns / double_count);
+}
+
+} // namespace mcga::cli::bench
@@ -0,0 +1,63 @@
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <mcga/cli/option_index.hpp>
+
+#include "benchmark.hpp"
+
+namespace mcga::cli::bench {
+
+namespace {
+
+std::vector<std::string> make_option_names(std::size_t num_options) {
+  std::vector<std::string> names;
+  names.reserve(num_options);
+  for (std::size_t i = 0; i < num_options; ++i) {
+    names.push_back("generated-tool-option-" + std::to_string(i));
+  }
+  return names;
+}
+
+} // namespace
+
+// Per-token lookup cost of the flat hash index used by Parser, compared to the
+// std::map it replaced.
+void run_option_index_benchmarks() {
+  for (std::size_t num_options: {10, 100, 1000, 5000}) {
+    std::vector<std::string> names = make_option_names(num_options);
+    std::vector<std::string_view> tokens(names.begin(), names.end());
+    // Lookups are done in a scrambled order, to avoid favouring either
+    // structure through access locality.
+    for (std::size_t i = 0; i < tokens.size(); ++i) {
+      std::swap(tokens[i], tokens[(i * 7919) % tokens.size()]);
+    }
+
+    std::map<std::string, std::shared_ptr<int>, std::less<>> map;
+    internal::OptionIndex index;
+    for (std::size_t i = 0; i < names.size(); ++i) {
+      map[names[i]] = std::make_shared<int>(static_cast<int>(i));
+      index.insert(names[i], static_cast<std::uint32_t>(i));
+    }
+    index.build();
+
+    std::size_t iterations = 2000000 / num_options + 1;
+    double map_ns = measure_ns(iterations, [&] {
+      for (std::string_view token: tokens) {
+        do_not_optimize(map.find(token));
+      }
+    });
+    double index_ns = measure_ns(iterations, [&] {
+      for (std::string_view token: tokens) {
+        do_not_optimize(index.find(token));
+      }
+    });
+    auto suffix = "/" + std::to_string(num_options) + "_options";
+    report("lookup/std_map" + suffix,
+           map_ns / static_cast<double>(num_options));
+    report("lookup/option_index" + suffix,
+           index_ns / static_cast<double>(num_options));
+  }
+}
+
+} // namespace mcga::cli::bench
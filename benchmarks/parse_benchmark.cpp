@@ -0,0 +1,175 @@
+#include <array>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if __has_include(<getopt.h>)
+#include <getopt.h>
+#define MCGA_CLI_HAS_GETOPT_LONG
+#endif
+
+#include <mcga/cli.hpp>
+
+#include "benchmark.hpp"
+
+namespace mcga::cli::bench {
+
+namespace {
+
+constexpr std::size_t num_long_options = 64;
+constexpr std::size_t iterations = 20000;
+
+// The arguments of a command line, with a program name in front for
+// getopt_long. `argv` points into `storage`, and getopt_long may reorder it.
+struct CommandLine {
+  explicit CommandLine(std::vector<std::string> args)
+      : storage(std::move(args)) {
+    argv.push_back(program_name.data());
+    for (std::string& arg: storage) {
+      argv.push_back(arg.data());
+    }
+  }
+
+  [[nodiscard]] std::span<const char* const> args() const {
+    return {argv.data() + 1, argv.size() - 1};
+  }
+
+  std::string program_name = "bench";
+  std::vector<std::string> storage;
+  std::vector<char*> argv;
+};
+
+void report_per_arg(const std::string& name, const CommandLine& command_line,
+                    double ns_per_parse) {
+  report(name, ns_per_parse / static_cast<double>(command_line.storage.size()));
+}
+
+#ifdef MCGA_CLI_HAS_GETOPT_LONG
+// getopt_long keeps its state in globals, which are reset by setting optind
+// to 0. The leading '-' of `short_options` reports non-options in order, as
+// code 1, instead of permuting them to the end.
+template<class OnOption>
+double measure_getopt_long(CommandLine& command_line, const char* short_options,
+                           const option* long_options, OnOption&& on_option) {
+  return measure_ns(iterations, [&] {
+    optind = 0;
+    opterr = 0;
+    int code = 0;
+    while ((code = getopt_long(static_cast<int>(command_line.argv.size()),
+                               command_line.argv.data(), short_options,
+                               long_options, nullptr)) != -1) {
+      on_option(code, optarg);
+    }
+  });
+}
+#endif
+
+void run_short_cluster_benchmarks() {
+  Parser parser("");
+  std::array<Flag, 26> flags;
+  for (char name = 'a'; name <= 'z'; ++name) {
+    std::string short_name(1, name);
+    flags[name - 'a'] = parser.add_flag(
+        FlagSpec("flag-" + short_name).set_short_name(short_name));
+  }
+  CommandLine command_line(
+      std::vector<std::string>(32, "-abcdefghijklmnopqrstuvwxyz"));
+
+  double parse_ns = measure_ns(iterations, [&] {
+    parser.parse(command_line.args());
+    do_not_optimize(flags[25]->get_value());
+  });
+  report_per_arg("parse/short_clusters", command_line, parse_ns);
+
+#ifdef MCGA_CLI_HAS_GETOPT_LONG
+  std::array<bool, 26> values{};
+  double getopt_ns = measure_getopt_long(
+      command_line, "-abcdefghijklmnopqrstuvwxyz", nullptr,
+      [&](int code, const char* /*value*/) {
+        values[code - 'a'] = true;
+      });
+  do_not_optimize(values);
+  report_per_arg("parse/short_clusters/getopt_long", command_line, getopt_ns);
+#endif
+}
+
+void run_long_value_benchmarks() {
+  Parser parser("");
+  std::vector<Argument> arguments;
+  std::vector<std::string> names;
+  std::vector<std::string> args;
+  for (std::size_t i = 0; i < num_long_options; ++i) {
+    names.push_back("option-" + std::to_string(i));
+    arguments.push_back(parser.add_argument(ArgumentSpec(names.back())));
+    args.push_back("--" + names.back() + "=value-" + std::to_string(i));
+  }
+  CommandLine command_line(args);
+
+  double parse_ns = measure_ns(iterations, [&] {
+    parser.parse(command_line.args());
+    do_not_optimize(arguments.back()->get_value_view().size());
+  });
+  report_per_arg("parse/long_values", command_line, parse_ns);
+
+#ifdef MCGA_CLI_HAS_GETOPT_LONG
+  std::vector<option> long_options;
+  for (std::size_t i = 0; i < num_long_options; ++i) {
+    long_options.push_back({names[i].c_str(), required_argument, nullptr,
+                            static_cast<int>(256 + i)});
+  }
+  long_options.push_back({nullptr, 0, nullptr, 0});
+  std::vector<const char*> values(num_long_options);
+  double getopt_ns = measure_getopt_long(
+      command_line, "-", long_options.data(),
+      [&](int code, const char* value) {
+        values[code - 256] = value;
+      });
+  do_not_optimize(values.back());
+  report_per_arg("parse/long_values/getopt_long", command_line, getopt_ns);
+#endif
+}
+
+void run_positional_benchmarks() {
+  Parser parser("");
+  auto flag = parser.add_flag(FlagSpec("verbose").set_short_name("v"));
+  std::vector<std::string> args{"-v"};
+  for (std::size_t i = 0; i < 1000; ++i) {
+    args.push_back("file-" + std::to_string(i) + ".txt");
+  }
+  CommandLine command_line(args);
+
+  double parse_ns = measure_ns(iterations / 10, [&] {
+    do_not_optimize(parser.parse(command_line.args()).size());
+  });
+  report_per_arg("parse/positionals", command_line, parse_ns);
+
+#ifdef MCGA_CLI_HAS_GETOPT_LONG
+  std::size_t num_positionals = 0;
+  const option long_options[] = {{"verbose", no_argument, nullptr, 'v'},
+                                 {nullptr, 0, nullptr, 0}};
+  double getopt_ns = measure_getopt_long(
+      command_line, "-v", long_options, [&](int code, const char* value) {
+        if (code == 1) {
+          do_not_optimize(value);
+          ++num_positionals;
+        }
+      });
+  do_not_optimize(num_positionals);
+  report_per_arg("parse/positionals/getopt_long", command_line, getopt_ns);
+#endif
+  do_not_optimize(flag->get_value());
+}
+
+} // namespace
+
+// Parse throughput, per argument, over command lines of different shapes,
+// compared to getopt_long where it is available. getopt_long only records
+// where the values are, while the parser also stores them.
+void run_parse_benchmarks() {
+  run_short_cluster_benchmarks();
+  run_long_value_benchmarks();
+  run_positional_benchmarks();
+}
+
+} // namespace mcga::cli::bench
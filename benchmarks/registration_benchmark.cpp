@@ -0,0 +1,46 @@
+#include <string>
+#include <vector>
+
+#include <mcga/cli.hpp>
+
+#include "benchmark.hpp"
+
+namespace mcga::cli::bench {
+
+// Startup cost of a parser: registering its options, and the first parse,
+// which builds the name indices. Reported per option.
+void run_registration_benchmarks() {
+  for (std::size_t num_options: {10, 1000, 10000}) {
+    std::vector<ArgumentSpec> specs;
+    specs.reserve(num_options);
+    for (std::size_t i = 0; i < num_options; ++i) {
+      specs.push_back(ArgumentSpec("option-" + std::to_string(i))
+                          .set_description("Option number " +
+                                           std::to_string(i) + ".")
+                          .set_default_value("value"));
+    }
+    std::vector<std::string> args{"--option-0=x"};
+
+    std::size_t iterations = 100000 / num_options + 1;
+    double register_ns = measure_ns(iterations, [&] {
+      Parser parser("");
+      for (const ArgumentSpec& spec: specs) {
+        do_not_optimize(parser.add_argument(spec).get());
+      }
+    });
+    double startup_ns = measure_ns(iterations, [&] {
+      Parser parser("");
+      for (const ArgumentSpec& spec: specs) {
+        parser.add_argument(spec);
+      }
+      do_not_optimize(parser.parse(args).size());
+    });
+    auto suffix = "/" + std::to_string(num_options) + "_options";
+    const auto count = static_cast<double>(num_options);
+    report("registration/add_argument" + suffix, register_ns / count);
+    report("registration/add_argument_and_parse" + suffix,
+           startup_ns / count);
+  }
+}
+
+} // namespace mcga::cli::bench
@@ -0,0 +1,107 @@
+// Validates command lines of a sample job-runner tool against its schema.
+//
+// Command lines are read from standard input, one per line (or separated by
+// NUL bytes with --null), and split into arguments on whitespace. Every
+// invalid command line is reported, and the exit code is 1 if any was found.
+
+#include <cctype>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <mcga/cli.hpp>
+
+using mcga::cli::ArgumentSpec;
+using mcga::cli::ChoiceArgumentSpec;
+using mcga::cli::FlagSpec;
+using mcga::cli::ListArgumentSpec;
+using mcga::cli::NumericArgumentSpec;
+using mcga::cli::Parser;
+
+namespace {
+
+void add_job_runner_options(Parser& parser) {
+  parser.add_argument(ArgumentSpec("name").set_short_name("n"));
+  parser.add_numeric_argument<int>(
+      NumericArgumentSpec("cpus").set_short_name("c").set_default_value("1"));
+  parser.add_numeric_argument<long long>(
+      NumericArgumentSpec("memory").set_short_name("m").set_default_value(
+          "1073741824"));
+  parser.add_choice_argument(ChoiceArgumentSpec<int>("priority")
+                                 .set_short_name("p")
+                                 .add_option("low", 0)
+                                 .add_option("normal", 1)
+                                 .add_option("high", 2)
+                                 .set_default_value("normal"));
+  parser.add_list_argument(
+      ListArgumentSpec("tag").set_short_name("t").set_default_value({}));
+  parser.add_flag(FlagSpec("dry-run").set_short_name("d"));
+}
+
+std::vector<Parser::ArgList> read_command_lines(std::istream& in,
+                                                char delimiter) {
+  std::vector<Parser::ArgList> command_lines;
+  std::string input(std::istreambuf_iterator<char>(in), {});
+  Parser::ArgList args;
+  std::string arg;
+  for (char c: input) {
+    if (c == delimiter) {
+      if (!arg.empty()) {
+        args.push_back(std::move(arg));
+        arg.clear();
+      }
+      command_lines.push_back(std::move(args));
+      args.clear();
+    } else if (std::isspace(static_cast<unsigned char>(c)) != 0) {
+      if (!arg.empty()) {
+        args.push_back(std::move(arg));
+        arg.clear();
+      }
+    } else {
+      arg += c;
+    }
+  }
+  if (!arg.empty()) {
+    args.push_back(std::move(arg));
+  }
+  if (!args.empty()) {
+    command_lines.push_back(std::move(args));
+  }
+  return command_lines;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Parser cli("Validate job-runner command lines read from standard input.");
+  cli.add_help_flag();
+  auto null_delimited = cli.add_flag(
+      FlagSpec("null").set_short_name("0").set_description(
+          "Command lines are separated by NUL bytes instead of newlines."));
+  cli.parse(argc, argv);
+
+  Parser job_runner("Job runner.");
+  add_job_runner_options(job_runner);
+
+  auto command_lines =
+      read_command_lines(std::cin, null_delimited->get_value() ? '\0' : '\n');
+  auto outcomes = job_runner.parse_batch(command_lines);
+
+  std::size_t num_invalid = 0;
+  for (std::size_t i = 0; i < outcomes.size(); ++i) {
+    if (!outcomes[i].error) {
+      continue;
+    }
+    num_invalid += 1;
+    try {
+      std::rethrow_exception(outcomes[i].error);
+    } catch (const std::exception& error) {
+      std::cout << "command line " << i + 1 << ": " << error.what() << "\n";
+    }
+  }
+  std::cout << outcomes.size() - num_invalid << "/" << outcomes.size()
+            << " command lines are valid.\n";
+  return num_invalid == 0 ? 0 : 1;
+}
@@ -5,3 +5,4 @@
 #include "cli/flag.hpp"
 #include "cli/numeric_argument.hpp"
 #include "cli/parser.hpp"
+#include "cli/static_parser.hpp"
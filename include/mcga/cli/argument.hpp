@@ -1,8 +1,10 @@
 #pragma once
 
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <string>
+#include <string_view>
 
 #include "command_line_option.hpp"
 #include "disallow_copy_and_move.hpp"
@@ -17,19 +19,26 @@ struct ArgumentSpec {
   std::string description;
   std::string help_group;
   std::string short_name;
+  std::string env_var;
   std::optional<internal::Generator> default_value;
   std::optional<internal::Generator> implicit_value;
+  bool independent_default_value = false;
 
   explicit ArgumentSpec(std::string name);
 
   ArgumentSpec& set_description(std::string description_);
   ArgumentSpec& set_help_group(std::string help_group_);
   ArgumentSpec& set_short_name(std::string short_name_);
+  ArgumentSpec& set_env_var(std::string env_var_);
 
   ArgumentSpec& set_default_value(const std::string& default_value_);
   ArgumentSpec& set_default_value_generator(
       const std::function<std::string()>& default_value_gen,
       const std::string& default_value_desc = "<no description>");
+  // Declare that the default value generator does not depend on any other
+  // generator, so that it can run concurrently with them, see
+  // Parser::enable_concurrent_defaults.
+  ArgumentSpec& set_independent_default_value(bool independent = true);
 
   ArgumentSpec& set_implicit_value(const std::string& implicit_value_);
   ArgumentSpec& set_implicit_value_generator(
@@ -41,7 +50,13 @@ namespace internal {
 
 class ArgumentImpl: public CommandLineOption {
 public:
-  explicit ArgumentImpl(const ArgumentSpec& spec);
+  explicit ArgumentImpl(
+      const ArgumentSpec& spec,
+      std::pmr::memory_resource* resource_ = std::pmr::get_default_resource());
+
+  explicit ArgumentImpl(
+      std::shared_ptr<const ArgumentSpec> spec,
+      std::pmr::memory_resource* resource_ = std::pmr::get_default_resource());
 
   ~ArgumentImpl() override = default;
 
@@ -49,21 +64,31 @@ public:
 
   [[nodiscard]] std::string get_value() const;
 
+  // The value without copying it, valid until the next parse.
+  [[nodiscard]] std::string_view get_value_view() const;
+
+  [[nodiscard]] std::optional<std::string_view>
+      get_value_view_if_exists() const;
+
   [[nodiscard]] const ArgumentSpec& get_spec() const;
 
 private:
   MCGA_DISALLOW_COPY_AND_MOVE(ArgumentImpl);
 
+  [[nodiscard]] std::shared_ptr<CommandLineOption>
+      create_instance(
+          std::pmr::memory_resource* instance_resource) const override;
+
   [[nodiscard]] const std::string& get_name() const override;
 
   void set_default() override;
 
   void set_implicit() override;
 
-  void set_value(const std::string& value_) override;
+  void set_value(std::string_view value_) override;
 
-  ArgumentSpec spec;
-  std::string value;
+  std::shared_ptr<const ArgumentSpec> spec;
+  std::pmr::string value;
 
   friend class mcga::cli::Parser;
   template<typename EArg>
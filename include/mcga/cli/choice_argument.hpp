@@ -2,10 +2,12 @@
 
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <utility>
 #include <vector>
 
+#include "choice_table.hpp"
 #include "command_line_option.hpp"
 #include "disallow_copy_and_move.hpp"
 #include "exceptions.hpp"
@@ -19,9 +21,18 @@ struct ChoiceArgumentSpec {
   std::string description;
   std::string help_group;
   std::string short_name;
+  std::string env_var;
+  // The options added to the spec. Registering the argument moves them into
+  // `table`, so the spec of a registered argument has none left here, see
+  // `get_options`.
   std::map<std::string, T> options;
+  // The options frozen when the argument was registered, shared by its spec,
+  // the argument and its instances. Null until then.
+  std::shared_ptr<const internal::ChoiceTable<T>> table;
   std::optional<internal::Generator> default_value;
   std::optional<internal::Generator> implicit_value;
+  bool independent_default_value = false;
+  bool case_insensitive = false;
 
   explicit ChoiceArgumentSpec(std::string name_): name(std::move(name_)) {}
 
@@ -30,6 +41,11 @@ struct ChoiceArgumentSpec {
     return *this;
   }
 
+  ChoiceArgumentSpec& set_env_var(const std::string& env_var_) {
+    env_var = env_var_;
+    return *this;
+  }
+
   ChoiceArgumentSpec& set_description(const std::string& description_) {
     description = description_;
     return *this;
@@ -56,6 +72,14 @@ struct ChoiceArgumentSpec {
     return *this;
   }
 
+  // Declare that the default value generator does not depend on any other
+  // generator, so that it can run concurrently with them, see
+  // Parser::enable_concurrent_defaults.
+  ChoiceArgumentSpec& set_independent_default_value(bool independent = true) {
+    independent_default_value = independent;
+    return *this;
+  }
+
   ChoiceArgumentSpec& set_implicit_value(const std::string& implicit_value_) {
     implicit_value.emplace(
         [implicit_value_]() {
@@ -72,6 +96,13 @@ struct ChoiceArgumentSpec {
     return *this;
   }
 
+  // Match the values given to the argument with the options ignoring the
+  // case of ASCII letters. The options must then differ by more than case.
+  ChoiceArgumentSpec& set_case_insensitive(bool case_insensitive_ = true) {
+    case_insensitive = case_insensitive_;
+    return *this;
+  }
+
   ChoiceArgumentSpec&
       set_options(const std::vector<std::pair<std::string, T>>& options_) {
     options.clear();
@@ -90,6 +121,33 @@ struct ChoiceArgumentSpec {
     options[key] = value;
     return *this;
   }
+
+  // The options of the argument: those frozen into `table` once the argument
+  // is registered, those added so far before that.
+  [[nodiscard]] const std::map<std::string, T>& get_options() const {
+    return table != nullptr ? table->get_options() : options;
+  }
+
+  // A copy of the spec with its options moved into `table`, allocated from
+  // `resource`. Options added to a spec that was already frozen are merged
+  // into a new table, replacing the frozen ones with the same key.
+  [[nodiscard]] ChoiceArgumentSpec
+      frozen(std::pmr::memory_resource* resource =
+                 std::pmr::get_default_resource()) const {
+    ChoiceArgumentSpec copy = *this;
+    if (table != nullptr && options.empty()) {
+      return copy;
+    }
+    std::map<std::string, T> all_options = std::move(copy.options);
+    copy.options.clear();
+    if (table != nullptr) {
+      all_options.merge(std::map<std::string, T>(table->get_options()));
+    }
+    copy.table =
+        internal::allocate_shared_from<const internal::ChoiceTable<T>>(
+            resource, std::move(all_options), case_insensitive, resource);
+    return copy;
+  }
 };
 
 namespace internal {
@@ -97,15 +155,28 @@ namespace internal {
 template<class T>
 class ChoiceArgumentImpl: public CommandLineOption {
 public:
-  explicit ChoiceArgumentImpl(const ChoiceArgumentSpec<T>& spec)
-      : CommandLineOption(spec.default_value.has_value(),
-                          spec.implicit_value.has_value()),
-        spec(spec) {}
+  explicit ChoiceArgumentImpl(
+      const ChoiceArgumentSpec<T>& spec,
+      std::pmr::memory_resource* resource_ = std::pmr::get_default_resource())
+      : ChoiceArgumentImpl(allocate_shared_from<const ChoiceArgumentSpec<T>>(
+                               resource_, spec.frozen(resource_)),
+                           resource_) {}
+
+  // Instances of the same argument share its spec, and so the table frozen
+  // from its options. `spec` must be frozen, see ChoiceArgumentSpec::frozen.
+  explicit ChoiceArgumentImpl(
+      std::shared_ptr<const ChoiceArgumentSpec<T>> spec,
+      std::pmr::memory_resource* resource_ = std::pmr::get_default_resource())
+      : CommandLineOption(spec->default_value.has_value(),
+                          spec->implicit_value.has_value(),
+                          spec->independent_default_value, resource_),
+        spec(std::move(spec)),
+        table(this->spec->table) {}
 
   ~ChoiceArgumentImpl() override = default;
 
   const ChoiceArgumentSpec<T>& get_spec() const {
-    return spec;
+    return *spec;
   }
 
   [[nodiscard]] std::optional<T> get_value_if_exists() const {
@@ -113,45 +184,59 @@ public:
   }
 
   T get_value() const {
+    resolve_default();
+    return value;
+  }
+
+  // The value without copying it, valid until the next parse.
+  [[nodiscard]] const T& get_value_view() const {
+    resolve_default();
     return value;
   }
 
+  // A pointer to the value, or null when the argument did not appear.
+  [[nodiscard]] const T* get_value_view_if_exists() const {
+    return appeared() ? &get_value_view() : nullptr;
+  }
+
+protected:
+  std::shared_ptr<const ChoiceArgumentSpec<T>> spec;
+  std::shared_ptr<const ChoiceTable<T>> table;
+
 private:
   MCGA_DISALLOW_COPY_AND_MOVE(ChoiceArgumentImpl);
 
+  [[nodiscard]] std::shared_ptr<CommandLineOption>
+      create_instance(
+          std::pmr::memory_resource* instance_resource) const override {
+    return allocate_shared_from<ChoiceArgumentImpl>(instance_resource, spec,
+                                                    instance_resource);
+  }
+
   [[nodiscard]] const std::string& get_name() const override {
-    return spec.name;
+    return spec->name;
   }
 
   void set_default() override {
-    set_value(spec.default_value.value().generate());
+    set_value(spec->default_value.value().generate());
   }
 
   void set_implicit() override {
-    set_value(spec.implicit_value.value().generate());
+    set_value(spec->implicit_value.value().generate());
   }
 
-  void set_value(const std::string& value_) override {
-    auto it = spec.options.find(value_);
-    if (it != spec.options.end()) {
-      value = it->second;
+  void set_value(std::string_view value_) override {
+    std::optional<T> option = table->find(value_);
+    if (option.has_value()) {
+      value = *option;
       return;
     }
-    std::string rendered_options;
-    bool first = true;
-    for (const auto& option: spec.options) {
-      if (!first) {
-        rendered_options += ",";
-      }
-      first = false;
-      rendered_options += "'" + option.first + "'";
-    }
     internal::throw_invalid_argument_exception(
-        "Trying to set option `" + value_ + "` to argument " + spec.name +
-        ", which has options [" + rendered_options + "]");
+        "Trying to set option `" + std::string(value_) + "` to argument " +
+        spec->name + ", which has options [" + table->get_rendered_keys() +
+        "]");
   }
 
-  ChoiceArgumentSpec<T> spec;
   T value;
 
   friend class mcga::cli::Parser;
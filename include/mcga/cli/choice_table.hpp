@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "exceptions.hpp"
+#include "option_index.hpp"
+
+namespace mcga::cli::internal {
+
+constexpr char to_lower_ascii(char c) {
+  return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+constexpr bool equals_ignoring_case(std::string_view a, std::string_view b) {
+  return a.size() == b.size() &&
+         std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+           return to_lower_ascii(x) == to_lower_ascii(y);
+         });
+}
+
+// The values of flags, in any case, shared by Flag and StaticFlag.
+inline constexpr std::pair<std::string_view, bool> flag_values[] = {
+    {"0", false},        {"1", true},     {"disabled", false},
+    {"enabled", true},   {"false", false}, {"true", true},
+};
+
+// The options of a choice argument, frozen when the argument is registered
+// into a hash index over the keys, so that a lookup costs one hash and
+// (usually) a single key comparison, whatever the number of options. Case
+// insensitive tables index the keys in lower case, and lower the looked up
+// keys. The table keeps the options it was built from, so that it is the only
+// copy of them shared by the spec of the argument, the argument and its
+// instances.
+template<class T>
+class ChoiceTable {
+public:
+  explicit ChoiceTable(
+      std::map<std::string, T> options_, bool case_insensitive_ = false,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : options(std::move(options_)),
+        case_insensitive(case_insensitive_),
+        index(resource),
+        values(resource) {
+    build();
+  }
+
+  template<std::size_t N>
+  explicit ChoiceTable(
+      const std::pair<std::string_view, T> (&options_)[N],
+      bool case_insensitive_ = false,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : case_insensitive(case_insensitive_), index(resource), values(resource) {
+    for (const auto& [key, value]: options_) {
+      options.emplace(key, value);
+    }
+    build();
+  }
+
+  [[nodiscard]] const std::map<std::string, T>& get_options() const {
+    return options;
+  }
+
+  [[nodiscard]] std::optional<T> find(std::string_view key) const {
+    std::uint32_t position = OptionIndex::npos;
+    if (!case_insensitive) {
+      position = index.find(key);
+    } else if (key.size() <= max_inline_key_size) {
+      char lowered[max_inline_key_size];
+      std::transform(key.begin(), key.end(), lowered, to_lower_ascii);
+      position = index.find({lowered, key.size()});
+    } else {
+      position = index.find(lower(key));
+    }
+    if (position == OptionIndex::npos) {
+      return std::nullopt;
+    }
+    return values[position];
+  }
+
+  // The keys, in order, as "'a','b'".
+  [[nodiscard]] const std::string& get_rendered_keys() const {
+    return rendered_keys;
+  }
+
+private:
+  static constexpr std::size_t max_inline_key_size = 64;
+
+  static std::string lower(std::string_view key) {
+    std::string lowered(key);
+    std::transform(lowered.begin(), lowered.end(), lowered.begin(),
+                   to_lower_ascii);
+    return lowered;
+  }
+
+  void build() {
+    std::vector<std::string> lowered_keys;
+    for (const auto& [key, value]: options) {
+      rendered_keys += rendered_keys.empty() ? "'" : ",'";
+      rendered_keys += key;
+      rendered_keys += "'";
+      if (case_insensitive) {
+        lowered_keys.push_back(lower(key));
+        index.insert(lowered_keys.back(),
+                     static_cast<std::uint32_t>(values.size()));
+      } else {
+        index.insert(key, static_cast<std::uint32_t>(values.size()));
+      }
+      values.push_back(value);
+    }
+    index.build();
+    std::sort(lowered_keys.begin(), lowered_keys.end());
+    auto duplicate =
+        std::adjacent_find(lowered_keys.begin(), lowered_keys.end());
+    if (duplicate != lowered_keys.end()) {
+      throw_logic_error("Choice option `" + *duplicate +
+                        "` is given more than once, ignoring case.");
+    }
+  }
+
+  std::map<std::string, T> options;
+  bool case_insensitive;
+  OptionIndex index;
+  std::pmr::vector<T> values;
+  std::string rendered_keys;
+};
+
+// The options of a static choice argument, sorted at compile time.
+template<class T, std::size_t N>
+consteval std::array<std::pair<std::string_view, T>, N>
+    sort_choices(const std::pair<std::string_view, T> (&options)[N]) {
+  std::array<std::pair<std::string_view, T>, N> sorted{};
+  std::copy(options, options + N, sorted.begin());
+  std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+    return a.first < b.first;
+  });
+  return sorted;
+}
+
+template<class T, std::size_t N>
+consteval bool
+    has_unique_choices(const std::array<std::pair<std::string_view, T>, N>&
+                           sorted_options) {
+  return std::adjacent_find(sorted_options.begin(), sorted_options.end(),
+                            [](const auto& a, const auto& b) {
+                              return a.first == b.first;
+                            }) == sorted_options.end();
+}
+
+template<class T, std::size_t N>
+constexpr const T*
+    find_choice(const std::array<std::pair<std::string_view, T>, N>&
+                    sorted_options,
+                std::string_view key) {
+  auto it = std::lower_bound(sorted_options.begin(), sorted_options.end(), key,
+                             [](const auto& option, std::string_view k) {
+                               return option.first < k;
+                             });
+  if (it == sorted_options.end() || it->first != key) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+} // namespace mcga::cli::internal
@@ -1,28 +1,69 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <utility>
 
 #include "disallow_copy_and_move.hpp"
 
 namespace mcga::cli {
 
+class ParseResult;
 class Parser;
+class ParserSchema;
 
 } // namespace mcga::cli
 
 namespace mcga::cli::internal {
 
+// Allocate a shared object, along with its control block, from `resource`.
+template<class T, class... Args>
+std::shared_ptr<T> allocate_shared_from(std::pmr::memory_resource* resource,
+                                        Args&&... args) {
+  return std::allocate_shared<T>(std::pmr::polymorphic_allocator<>(resource),
+                                 std::forward<Args>(args)...);
+}
+
+// Whether `resource` can be used from several threads at once. Only the
+// resources of the standard library known to be thread-safe are recognized:
+// new_delete_resource, null_memory_resource and synchronized_pool_resource.
+[[nodiscard]] bool is_synchronized(const std::pmr::memory_resource* resource);
+
 class CommandLineOption {
 public:
   [[nodiscard]] bool appeared() const;
 
 protected:
-  CommandLineOption(bool has_default_value_, bool has_implicit_value_);
+  // The values of the option, and the instances created from it, are
+  // allocated from `resource_`.
+  CommandLineOption(
+      bool has_default_value_, bool has_implicit_value_,
+      bool independent_default_value_ = false,
+      std::pmr::memory_resource* resource_ = std::pmr::get_default_resource());
 
   virtual ~CommandLineOption() = default;
 
   virtual void reset();
 
+  // Generate the default value if its generation was deferred until the value
+  // is first read. Called by the accessors of the options before reading the
+  // value. Several threads can read the same option at once: the generator
+  // runs on one of them, and the others wait for it.
+  void resolve_default() const;
+
+  // Create a new option with the same spec, that did not take part in any
+  // parse, allocated (along with its values) from `instance_resource`. Used to
+  // hold the state of one parse of an immutable ParserSchema.
+  [[nodiscard]] virtual std::shared_ptr<CommandLineOption>
+      create_instance(std::pmr::memory_resource* instance_resource) const = 0;
+
+  std::pmr::memory_resource* resource;
+
 private:
   MCGA_DISALLOW_COPY_AND_MOVE(CommandLineOption);
 
@@ -34,19 +75,39 @@ private:
 
   virtual void set_implicit() = 0;
 
-  virtual void set_value(const std::string& value) = 0;
+  virtual void set_value(std::string_view value) = 0;
 
-  void set_default_guarded();
+  // With `lazy`, the default value is only generated by `resolve_default`.
+  // A default value generated (or deferred) by a previous parse is kept,
+  // unless the option was reset since.
+  void set_default_guarded(bool lazy = false);
 
   void set_implicit_guarded();
 
-  void set_value_guarded(const std::string& value);
+  void set_value_guarded(std::string_view value);
+
+  enum class DefaultState : std::uint8_t {
+    none,
+    deferred,
+    generated,
+  };
 
   bool appeared_in_args = false;
+  // Only changed concurrently by `resolve_default`, under `resolve_mutex`.
+  // Parses write it with relaxed stores, as they own the option.
+  mutable std::atomic<DefaultState> default_state = DefaultState::none;
+  mutable std::mutex resolve_mutex;
   bool has_default_value;
   bool has_implicit_value;
+  bool independent_default_value;
+  std::uint32_t index = 0;
+  // The option this one is an instance of, see `create_instance`. Null for
+  // the options registered to a Parser.
+  const CommandLineOption* prototype = nullptr;
 
+  friend class mcga::cli::ParseResult;
   friend class mcga::cli::Parser;
+  friend class mcga::cli::ParserSchema;
 };
 
 } // namespace mcga::cli::internal
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "option_index.hpp"
+
+namespace mcga::cli::internal {
+
+// One "name = value" (or bare "name") line of a config file.
+struct ConfigEntry {
+  std::uint32_t option_index;
+  bool implicit;
+  std::string_view value;
+};
+
+// Option values read from config files. Every line of a config file is
+// either empty, a comment starting with '#' or ';', an "include <path>"
+// directive (relative paths are relative to the including file), a bare
+// option name, which sets the option to its implicit value, or
+// "name = value". Values can be wrapped in single or double quotes to keep
+// surrounding whitespace. Files are memory-mapped and parsed in a single pass,
+// looking up each name in the option index, and the entries are views into
+// the mappings, which copies of this object share.
+class ConfigFiles {
+public:
+  void load(const std::filesystem::path& path, const OptionIndex& index);
+
+  // The entries of all loaded files, grouped by option in loading order.
+  [[nodiscard]] const std::vector<ConfigEntry>& get_entries() const;
+
+private:
+  void load_file(const std::filesystem::path& path, const OptionIndex& index,
+                 std::vector<std::filesystem::path>& open_files);
+
+  std::vector<std::shared_ptr<const MappedFile>> files;
+  std::vector<ConfigEntry> entries;
+};
+
+} // namespace mcga::cli::internal
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "option_index.hpp"
+
+namespace mcga::cli::internal {
+
+struct EnvironmentValue {
+  std::uint32_t option_index;
+  std::string_view value;
+};
+
+// The values of the variables in `env_vars` that are set in the environment,
+// in the order of the environment. The environment is scanned once, and each
+// variable is looked up in `env_vars`, so the cost does not grow with the
+// number of options, as calling getenv for every option would.
+std::vector<EnvironmentValue> read_environment(const OptionIndex& env_vars);
+
+} // namespace mcga::cli::internal
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <memory_resource>
 #include <string>
 
 #include "choice_argument.hpp"
@@ -13,25 +14,37 @@ struct FlagSpec {
   std::string description;
   std::string help_group;
   std::string short_name;
+  std::string env_var;
 
   explicit FlagSpec(std::string name_);
 
   FlagSpec& set_description(std::string description_);
   FlagSpec& set_help_group(std::string help_group_);
   FlagSpec& set_short_name(std::string short_name_);
+  FlagSpec& set_env_var(std::string env_var_);
 };
 
 namespace internal {
 
 class FlagImpl: public internal::ChoiceArgumentImpl<bool> {
 public:
-  explicit FlagImpl(const FlagSpec& spec);
+  explicit FlagImpl(
+      const FlagSpec& spec,
+      std::pmr::memory_resource* resource_ = std::pmr::get_default_resource());
+
+  explicit FlagImpl(
+      std::shared_ptr<const ChoiceArgumentSpec<bool>> spec,
+      std::pmr::memory_resource* resource_ = std::pmr::get_default_resource());
 
   ~FlagImpl() override = default;
 
 private:
   MCGA_DISALLOW_COPY_AND_MOVE(FlagImpl);
 
+  [[nodiscard]] std::shared_ptr<CommandLineOption>
+      create_instance(
+          std::pmr::memory_resource* instance_resource) const override;
+
   [[nodiscard]] bool consumes_next_positional_arg() const override;
 
   friend class mcga::cli::Parser;
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace mcga::cli::internal {
+
+// The help of one option. All the pieces point into the spec of the option,
+// which lives as long as the option, so recording an entry copies no strings.
+struct HelpEntry {
+  const std::string* group = nullptr;
+  const std::string* name = nullptr;
+  const std::string* short_name = nullptr;
+  const std::string* description = nullptr;
+  const std::string* default_description = nullptr;
+  const std::string* implicit_description = nullptr;
+  // Renders the allowed values of choice arguments, as "['a','b']".
+  std::function<std::string()> allowed_values;
+
+  template<class Spec>
+  static HelpEntry from_spec(const Spec& spec) {
+    HelpEntry entry;
+    entry.group = &spec.help_group;
+    entry.name = &spec.name;
+    entry.short_name = &spec.short_name;
+    entry.description = &spec.description;
+    if (spec.default_value.has_value()) {
+      entry.default_description = &spec.default_value->get_description();
+    }
+    if (spec.implicit_value.has_value()) {
+      entry.implicit_description = &spec.implicit_value->get_description();
+    }
+    return entry;
+  }
+};
+
+// Help of a parser, as a table of options grouped by help group. Entries are
+// only recorded when options are registered: the text is built the first time
+// it is rendered, and cached until the next entry.
+class HelpTable {
+public:
+  explicit HelpTable(
+      std::string prefix_,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+  void add(HelpEntry entry);
+
+  // Options without a group come right after the prefix, followed by the
+  // groups in the order of their first option, each option on a tab-indented
+  // line, followed by an indented line with its default and implicit values.
+  [[nodiscard]] const std::string& render() const;
+
+  // Like `render`, with the names and descriptions aligned in two columns,
+  // and descriptions wrapped so that lines fit in `width` characters.
+  [[nodiscard]] const std::string& render(std::size_t width) const;
+
+  // The width of the terminal standard output is attached to, or of the
+  // COLUMNS environment variable, or 80.
+  static std::size_t terminal_width();
+
+private:
+  struct Group {
+    const std::string* name;
+    std::vector<const HelpEntry*> entries;
+  };
+
+  [[nodiscard]] std::vector<Group> group_entries() const;
+
+  static std::string render_extra(const HelpEntry& entry);
+
+  std::string prefix;
+  std::pmr::vector<HelpEntry> entries;
+
+  mutable std::string cached_help;
+  mutable bool has_cached_help = false;
+  mutable std::string cached_table;
+  mutable std::size_t cached_table_width = 0;
+};
+
+} // namespace mcga::cli::internal
@@ -3,10 +3,17 @@
 #include "command_line_option.hpp"
 #include "disallow_copy_and_move.hpp"
 #include "generator.hpp"
+#include "numeric_argument.hpp"
+#include <algorithm>
 #include <memory>
+#include <memory_resource>
 #include <numeric>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 namespace mcga::cli {
 
@@ -42,8 +49,11 @@ struct ListArgumentSpec {
   std::string description;
   std::string help_group;
   std::string short_name;
+  std::string env_var;
   std::optional<internal::ListGenerator> default_value;
   std::optional<internal::ListGenerator> implicit_value;
+  bool independent_default_value = false;
+  char delimiter = 0;
 
   explicit ListArgumentSpec(std::string name): name(std::move(name)) {}
 
@@ -62,6 +72,18 @@ struct ListArgumentSpec {
     return *this;
   }
 
+  ListArgumentSpec& set_env_var(std::string env_var_) {
+    env_var = std::move(env_var_);
+    return *this;
+  }
+
+  // Split every value of the list on `delimiter_`, so that `--ids=1,2,3`
+  // adds three elements.
+  ListArgumentSpec& set_delimiter(char delimiter_) {
+    delimiter = delimiter_;
+    return *this;
+  }
+
   ListArgumentSpec&
       set_default_value(const std::vector<std::string>& default_value_) {
     return set_default_value_generator(
@@ -78,6 +100,14 @@ struct ListArgumentSpec {
     return *this;
   }
 
+  // Declare that the default value generator does not depend on any other
+  // generator, so that it can run concurrently with them, see
+  // Parser::enable_concurrent_defaults.
+  ListArgumentSpec& set_independent_default_value(bool independent = true) {
+    independent_default_value = independent;
+    return *this;
+  }
+
   ListArgumentSpec&
       set_implicit_value(const std::vector<std::string>& implicit_value_) {
     return set_implicit_value_generator(
@@ -104,27 +134,70 @@ class ListArgumentImpl: public CommandLineOption {
   using EltImpl = typename EArg::element_type;
 
 public:
-  explicit ListArgumentImpl(const ListArgumentSpec<EArg>& spec)
-      : CommandLineOption(spec.default_value.has_value(),
-                          spec.implicit_value.has_value()),
+  // A span over the values, except for lists of flags, whose values are
+  // packed and can only be viewed as the vector holding them.
+  using ValueView =
+      std::conditional_t<std::is_same_v<ValueType, bool>,
+                         const std::pmr::vector<bool>&,
+                         std::span<const ValueType>>;
+
+  explicit ListArgumentImpl(
+      const ListArgumentSpec<EArg>& spec,
+      std::pmr::memory_resource* resource_ = std::pmr::get_default_resource())
+      : ListArgumentImpl(allocate_shared_from<const ListArgumentSpec<EArg>>(
+                             resource_, spec),
+                         resource_) {}
+
+  explicit ListArgumentImpl(
+      std::shared_ptr<const ListArgumentSpec<EArg>> spec,
+      std::pmr::memory_resource* resource_ = std::pmr::get_default_resource())
+      : CommandLineOption(spec->default_value.has_value(),
+                          spec->implicit_value.has_value(),
+                          spec->independent_default_value, resource_),
         spec(spec),
-        impl(SpecType(spec.name)) {}
+        value(resource_),
+        impl(SpecType(spec->name), resource_) {}
 
   ~ListArgumentImpl() override = default;
 
   [[nodiscard]] std::vector<ValueType> get_value() const {
+    resolve_default();
+    return {value.begin(), value.end()};
+  }
+
+  // The values without copying them, valid until the next parse.
+  [[nodiscard]] ValueView get_value_view() const {
+    resolve_default();
     return value;
   }
 
+  // The values, or std::nullopt when the argument did not appear. Lists of
+  // flags return a pointer to their values instead.
+  [[nodiscard]] auto get_value_view_if_exists() const {
+    if constexpr (std::is_same_v<ValueType, bool>) {
+      return appeared() ? &get_value_view() : nullptr;
+    } else {
+      return appeared() ? std::optional<ValueView>{get_value_view()}
+                        : std::nullopt;
+    }
+  }
+
   [[nodiscard]] const ListArgumentSpec<EArg>& get_spec() const {
-    return spec;
+    return *spec;
   }
 
 private:
   MCGA_DISALLOW_COPY_AND_MOVE(ListArgumentImpl);
 
+  [[nodiscard]] std::shared_ptr<CommandLineOption>
+      create_instance(
+          std::pmr::memory_resource* instance_resource) const override {
+    return allocate_shared_from<ListArgumentImpl>(instance_resource, spec,
+                                                  instance_resource);
+  }
+
   [[nodiscard]] const std::string& get_name() const override {
-    return spec.name;
+    return spec->name;
   }
 
   void reset() override {
@@ -135,30 +208,56 @@ private:
 
   void set_default() override {
     value.clear();
-    for (const std::string& val: spec.default_value.value().generate()) {
-      impl.set_value(val);
-      value.push_back(impl.get_value());
+    for (const std::string& val: spec->default_value.value().generate()) {
+      set_value(val);
     }
   }
 
   void set_implicit() override {
     if (!applied_implicit) {
-      for (const std::string& val: spec.implicit_value.value().generate()) {
-        impl.set_value(val);
-        value.push_back(impl.get_value());
+      for (const std::string& val: spec->implicit_value.value().generate()) {
+        set_value(val);
       }
       applied_implicit = true;
     }
   }
 
-  void set_value(const std::string& value_) override {
-    impl.set_value(value_);
-    value.push_back(impl.get_value());
+  void set_value(std::string_view value_) override {
+    if (spec->delimiter == 0) {
+      add_element(value_);
+      return;
+    }
+    // grow geometrically, as push_back would: reserving the exact size on
+    // every call would copy the whole list each time a delimited value is
+    // appended to it.
+    std::size_t needed =
+        value.size() + 1 +
+        std::count(value_.begin(), value_.end(), spec->delimiter);
+    if (needed > value.capacity()) {
+      value.reserve(std::max(needed, 2 * value.capacity()));
+    }
+    for (std::size_t end = value_.find(spec->delimiter);
+         end != std::string_view::npos; end = value_.find(spec->delimiter)) {
+      add_element(value_.substr(0, end));
+      value_.remove_prefix(end + 1);
+    }
+    add_element(value_);
+  }
+
+  void add_element(std::string_view element) {
+    if constexpr (std::is_same_v<EArg, NumericArgument<ValueType>>) {
+      // Numbers are converted straight into the list, without going through
+      // the element option.
+      value.push_back(from_string<ValueType>(element));
+    } else {
+      impl.set_value(element);
+      value.emplace_back(impl.get_value_view());
+    }
   }
 
   bool applied_implicit = false;
-  ListArgumentSpec<EArg> spec;
-  std::vector<ValueType> value;
+  std::shared_ptr<const ListArgumentSpec<EArg>> spec;
+  std::pmr::vector<ValueType> value;
   EltImpl impl;
 
   friend class mcga::cli::Parser;
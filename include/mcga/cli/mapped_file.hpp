@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+#include "disallow_copy_and_move.hpp"
+
+namespace mcga::cli::internal {
+
+// A file mapped privately into memory: it can be modified in place without
+// changing the file on disk.
+class MappedFile {
+public:
+  explicit MappedFile(const std::filesystem::path& path);
+
+  MCGA_DISALLOW_COPY_AND_MOVE(MappedFile);
+
+  ~MappedFile();
+
+  [[nodiscard]] std::span<char> contents() const;
+
+private:
+  char* data = nullptr;
+  std::size_t size = 0;
+};
+
+} // namespace mcga::cli::internal
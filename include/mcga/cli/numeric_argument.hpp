@@ -1,8 +1,10 @@
 #pragma once
 
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 
 #include "command_line_option.hpp"
@@ -16,18 +18,25 @@ struct NumericArgumentSpec {
   std::string description;
   std::string help_group;
   std::string short_name;
+  std::string env_var;
   std::optional<internal::Generator> default_value;
   std::optional<internal::Generator> implicit_value;
+  bool independent_default_value = false;
 
   explicit NumericArgumentSpec(std::string name_);
   NumericArgumentSpec& set_description(std::string description_);
   NumericArgumentSpec& set_help_group(std::string help_group_);
   NumericArgumentSpec& set_short_name(std::string short_name_);
+  NumericArgumentSpec& set_env_var(std::string env_var_);
 
   NumericArgumentSpec& set_default_value(const std::string& default_value_);
   NumericArgumentSpec& set_default_value_generator(
       const std::function<std::string()>& default_value_gen,
       const std::string& default_value_desc = "<no description>");
+  // Declare that the default value generator does not depend on any other
+  // generator, so that it can run concurrently with them, see
+  // Parser::enable_concurrent_defaults.
+  NumericArgumentSpec& set_independent_default_value(bool independent = true);
 
   NumericArgumentSpec& set_implicit_value(const std::string& implicit_value_);
   NumericArgumentSpec& set_implicit_value_generator(
@@ -37,55 +46,72 @@ struct NumericArgumentSpec {
 
 namespace internal {
 
+// Integers accept an optional sign, a `0x`, `0o` or `0b` radix prefix and `_`
+// digit separators, and must fit in `T` exactly. Floating point numbers are
+// parsed independently of the locale, and accept an optional sign, hexadecimal
+// numbers with a `0x` prefix, `inf` and `nan`.
 template<class T>
-T from_string(const std::string& value);
+T from_string(std::string_view value);
 
 template<>
-char from_string(const std::string& value);
+char from_string(std::string_view value);
 
 template<>
-unsigned char from_string(const std::string& value);
+signed char from_string(std::string_view value);
 
 template<>
-short int from_string(const std::string& value);
+unsigned char from_string(std::string_view value);
 
 template<>
-unsigned short int from_string(const std::string& value);
+short int from_string(std::string_view value);
 
 template<>
-int from_string(const std::string& value);
+unsigned short int from_string(std::string_view value);
 
 template<>
-unsigned int from_string(const std::string& value);
+int from_string(std::string_view value);
 
 template<>
-long from_string(const std::string& value);
+unsigned int from_string(std::string_view value);
 
 template<>
-unsigned long from_string(const std::string& value);
+long from_string(std::string_view value);
 
 template<>
-long long from_string(const std::string& value);
+unsigned long from_string(std::string_view value);
 
 template<>
-unsigned long long from_string(const std::string& value);
+long long from_string(std::string_view value);
 
 template<>
-float from_string(const std::string& value);
+unsigned long long from_string(std::string_view value);
 
 template<>
-double from_string(const std::string& value);
+float from_string(std::string_view value);
 
 template<>
-long double from_string(const std::string& value);
+double from_string(std::string_view value);
+
+template<>
+long double from_string(std::string_view value);
 
 template<class T>
 class NumericArgumentImpl: public CommandLineOption {
 public:
-  explicit NumericArgumentImpl(const NumericArgumentSpec& spec)
-      : CommandLineOption(spec.default_value.has_value(),
-                          spec.implicit_value.has_value()),
-        spec(spec) {}
+  explicit NumericArgumentImpl(
+      const NumericArgumentSpec& spec,
+      std::pmr::memory_resource* resource_ = std::pmr::get_default_resource())
+      : NumericArgumentImpl(
+            allocate_shared_from<const NumericArgumentSpec>(resource_, spec),
+            resource_) {}
+
+  explicit NumericArgumentImpl(
+      std::shared_ptr<const NumericArgumentSpec> spec,
+      std::pmr::memory_resource* resource_ = std::pmr::get_default_resource())
+      : CommandLineOption(spec->default_value.has_value(),
+                          spec->implicit_value.has_value(),
+                          spec->independent_default_value, resource_),
+        spec(std::move(spec)) {}
 
   ~NumericArgumentImpl() override = default;
 
@@ -94,29 +120,52 @@ public:
   }
 
   [[nodiscard]] T get_value() const {
+    resolve_default();
+    return value;
+  }
+
+  // The value without copying it, valid until the next parse.
+  [[nodiscard]] const T& get_value_view() const {
+    resolve_default();
     return value;
   }
 
+  // A pointer to the value, or null when the argument did not appear.
+  [[nodiscard]] const T* get_value_view_if_exists() const {
+    return appeared() ? &get_value_view() : nullptr;
+  }
+
+  [[nodiscard]] const NumericArgumentSpec& get_spec() const {
+    return *spec;
+  }
+
 private:
   MCGA_DISALLOW_COPY_AND_MOVE(NumericArgumentImpl);
 
+  [[nodiscard]] std::shared_ptr<CommandLineOption>
+      create_instance(
+          std::pmr::memory_resource* instance_resource) const override {
+    return allocate_shared_from<NumericArgumentImpl>(instance_resource, spec,
+                                                     instance_resource);
+  }
+
   [[nodiscard]] const std::string& get_name() const override {
-    return spec.name;
+    return spec->name;
   }
 
   void set_default() override {
-    set_value(spec.default_value.value().generate());
+    set_value(spec->default_value.value().generate());
   }
 
   void set_implicit() override {
-    set_value(spec.implicit_value.value().generate());
+    set_value(spec->implicit_value.value().generate());
   }
 
-  void set_value(const std::string& value_) override {
+  void set_value(std::string_view value_) override {
     value = from_string<T>(value_);
   }
 
-  NumericArgumentSpec spec;
+  std::shared_ptr<const NumericArgumentSpec> spec;
   T value;
 
   friend class mcga::cli::Parser;
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace mcga::cli::internal {
+
+// Flat open-addressing hash table from command-line names to option indices.
+// Names are inserted during registration, and the table is built once before
+// the first lookup, so that each lookup costs one hash and (usually) a single
+// key comparison. Single-character names (all short names, and any
+// one-character long names) are also kept in a table indexed directly by the
+// character, so the letters of a "-XYZ" cluster cost one array access each.
+class OptionIndex {
+public:
+  static constexpr std::uint32_t npos = UINT32_MAX;
+
+  explicit OptionIndex(
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+  void insert(std::string_view key, std::uint32_t value);
+
+  void build();
+
+  [[nodiscard]] bool is_built() const;
+
+  [[nodiscard]] std::uint32_t find(std::string_view key) const;
+
+  [[nodiscard]] std::uint32_t find_short(char key) const {
+    return short_slots[static_cast<unsigned char>(key)];
+  }
+
+  [[nodiscard]] std::size_t size() const;
+
+private:
+  struct Slot {
+    std::size_t hash = 0;
+    std::uint32_t key_offset = 0;
+    std::uint32_t key_length = 0;
+    std::uint32_t value = npos;
+  };
+
+  static std::size_t hash_key(std::string_view key);
+
+  static constexpr std::array<std::uint32_t, 256> make_empty_short_slots() {
+    std::array<std::uint32_t, 256> empty_short_slots{};
+    empty_short_slots.fill(npos);
+    return empty_short_slots;
+  }
+
+  std::pmr::vector<std::pair<std::pmr::string, std::uint32_t>> entries;
+  std::array<std::uint32_t, 256> short_slots = make_empty_short_slots();
+  std::pmr::vector<Slot> slots;
+  std::pmr::string keys;
+  std::size_t mask = 0;
+  bool built = false;
+};
+
+} // namespace mcga::cli::internal
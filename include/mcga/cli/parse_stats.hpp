@@ -0,0 +1,48 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace mcga::cli {
+
+// What the last parse of a Parser did, and where its time went, see
+// Parser::enable_parse_stats.
+struct ParseStats {
+  struct GeneratorTime {
+    // The name of the option, valid as long as the parser.
+    std::string_view option;
+    std::chrono::nanoseconds time;
+  };
+
+  // Arguments given to the tokenizer, after expanding response files.
+  std::size_t tokens = 0;
+  // Names looked up in the index of command-line names, and the ones that
+  // matched no option (which are ignored).
+  std::size_t lookups = 0;
+  std::size_t lookup_misses = 0;
+  // Options that got a value from the arguments, the environment or the
+  // config files.
+  std::size_t appeared_options = 0;
+  // Default values generated during the parse, not counting the ones that
+  // were deferred or kept from a previous parse.
+  std::size_t defaults_evaluated = 0;
+  // One entry per generated default value: first the independent ones
+  // generated concurrently, if enabled, then the others in the order of the
+  // options.
+  std::vector<GeneratorTime> generator_times;
+
+  // Wall time of each phase: resetting the options, tokenizing and applying
+  // the arguments, applying the environment, config files and default values,
+  // and running the terminal flags.
+  std::chrono::nanoseconds reset_time{0};
+  std::chrono::nanoseconds tokenize_time{0};
+  std::chrono::nanoseconds defaults_time{0};
+  std::chrono::nanoseconds terminal_flags_time{0};
+
+  // Reset every statistic, keeping the memory of `generator_times`.
+  void clear();
+};
+
+} // namespace mcga::cli
@@ -1,28 +1,208 @@
 #pragma once
 
-#include <map>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <initializer_list>
 #include <memory>
+#include <memory_resource>
 #include <set>
+#include <span>
+#include <string_view>
 #include <vector>
 
 #include "argument.hpp"
 #include "choice_argument.hpp"
 #include "command_line_option.hpp"
+#include "config_files.hpp"
 #include "flag.hpp"
+#include "help.hpp"
 #include "list_argument.hpp"
 #include "numeric_argument.hpp"
+#include "option_index.hpp"
+#include "parse_stats.hpp"
+#include "response_files.hpp"
 
 namespace mcga::cli {
 
+class Parser;
+class ParserSchema;
+
+// Runs a task, possibly on another thread. An executor that throws must not
+// run the task it was given.
+using Executor = std::function<void(std::function<void()>)>;
+
+namespace internal {
+
+// How a Parser was configured to parse, shared with the schemas it freezes.
+struct ParseSettings {
+  bool expand_response_files = false;
+  bool lazy_defaults = false;
+  bool keep_defaults = false;
+  bool concurrent_defaults = false;
+  // Runs the concurrent default value generators. Empty for an internal
+  // thread pool.
+  Executor executor;
+};
+
+} // namespace internal
+
+// The state of one parse of a ParserSchema. The handles returned by the
+// Parser the schema was frozen from can be used to read the values. Any
+// number of threads can read the same result, including its deferred default
+// values, which are generated once, by the first reader.
+class ParseResult {
+public:
+  using ArgViewList = std::vector<std::string_view>;
+
+  [[nodiscard]] const ArgViewList& positional_args() const;
+
+  // Generate the default values that are still deferred, see
+  // Parser::enable_lazy_defaults.
+  void resolve_all() const;
+
+  template<class Handle>
+  [[nodiscard]] typename Handle::ValueType get(const Handle& handle) const {
+    return option(handle).get_value();
+  }
+
+  template<class Handle>
+  [[nodiscard]] auto get_if_exists(const Handle& handle) const {
+    return option(handle).get_value_if_exists();
+  }
+
+  // The value without copying it, valid as long as the result.
+  template<class Handle>
+  [[nodiscard]] decltype(auto) get_view(const Handle& handle) const {
+    return option(handle).get_value_view();
+  }
+
+  template<class Handle>
+  [[nodiscard]] auto get_view_if_exists(const Handle& handle) const {
+    return option(handle).get_value_view_if_exists();
+  }
+
+  template<class Handle>
+  [[nodiscard]] bool appeared(const Handle& handle) const {
+    return option(handle).appeared();
+  }
+
+private:
+  template<class Handle>
+  [[nodiscard]] const typename Handle::element_type&
+      option(const Handle& handle) const {
+    return static_cast<const typename Handle::element_type&>(
+        instance_of(handle.get()));
+  }
+
+  // The instance of `prototype` in this result. Throws if `prototype` is not
+  // an option of the schema this result was parsed with.
+  [[nodiscard]] const internal::CommandLineOption&
+      instance_of(const internal::CommandLineOption* prototype) const;
+
+  std::vector<std::shared_ptr<internal::CommandLineOption>> options;
+  ArgViewList positional;
+  internal::ResponseFiles response_files;
+
+  friend class ParserSchema;
+};
+
+// Outcome of parsing one command line of a batch: either a result, or the
+// error raised while parsing it.
+struct ParseOutcome {
+  std::optional<ParseResult> result;
+  std::exception_ptr error;
+};
+
+// Immutable snapshot of the options registered to a Parser. Parsing does not
+// modify the schema, so one schema can be shared by any number of threads.
+// Terminal flags are not run when parsing through a schema.
+class ParserSchema {
+public:
+  using ArgList = std::vector<std::string>;
+
+  MCGA_DISALLOW_COPY_AND_MOVE(ParserSchema);
+
+  ~ParserSchema() = default;
+
+  // The positional arguments of the result are views into `args`, or into
+  // the response files they came from, which the result keeps mapped.
+  //
+  // The options of the result, and their values, are allocated from
+  // `resource` (not from the resource of the Parser, which concurrent parses
+  // would share), so it can be a per-request arena. It must outlive the
+  // result. Default values are only generated concurrently (see
+  // Parser::enable_concurrent_defaults) when `resource` is thread-safe, see
+  // internal::is_synchronized.
+  [[nodiscard]] ParseResult parse(
+      const ArgList& args,
+      std::pmr::memory_resource* resource =
+          std::pmr::get_default_resource()) const;
+  [[nodiscard]] ParseResult parse(
+      std::initializer_list<std::string_view> args,
+      std::pmr::memory_resource* resource =
+          std::pmr::get_default_resource()) const;
+  [[nodiscard]] ParseResult parse(
+      std::span<const std::string_view> args,
+      std::pmr::memory_resource* resource =
+          std::pmr::get_default_resource()) const;
+  [[nodiscard]] ParseResult parse(
+      std::span<const char* const> args,
+      std::pmr::memory_resource* resource =
+          std::pmr::get_default_resource()) const;
+
+  // Parse every command line of `batch` on the shared work-stealing thread
+  // pool, allocating the results from the global heap. Outcomes are returned
+  // in the order of `batch`.
+  [[nodiscard]] std::vector<ParseOutcome>
+      parse_batch(std::span<const ArgList> batch) const;
+
+  [[nodiscard]] const std::string& render_help() const;
+
+private:
+  using CommandLineOptionPtr = std::shared_ptr<internal::CommandLineOption>;
+
+  ParserSchema(std::vector<CommandLineOptionPtr> options_,
+               internal::OptionIndex index_,
+               internal::OptionIndex env_vars_index_,
+               internal::ConfigFiles config_files_, std::string help_,
+               internal::ParseSettings settings_);
+
+  template<class Args>
+  [[nodiscard]] ParseResult
+      parse_args(const Args& args, std::pmr::memory_resource* resource) const;
+
+  std::vector<CommandLineOptionPtr> options;
+  internal::OptionIndex index;
+  internal::OptionIndex env_vars_index;
+  internal::ConfigFiles config_files;
+  std::string help;
+  internal::ParseSettings settings;
+
+  friend class Parser;
+};
+
 class Parser {
 public:
   using ArgList = std::vector<std::string>;
+  using ArgViewList = std::vector<std::string_view>;
+  using PmrArgViewList = std::pmr::vector<std::string_view>;
 
-  explicit Parser(const std::string& help_prefix_);
+  // The options, their values and the indices over their names are allocated
+  // from `resource_`. It must outlive the parser, the schemas frozen from it
+  // and the handles returned by the `add_*` methods, which own their options
+  // and give their memory back to `resource_` when the last of them is gone.
+  // Parsing the schemas does not use it, see ParserSchema::parse. Default
+  // values are only generated concurrently (see `enable_concurrent_defaults`)
+  // when `resource_` is thread-safe, see internal::is_synchronized.
+  explicit Parser(
+      const std::string& help_prefix_,
+      std::pmr::memory_resource* resource_ = std::pmr::get_default_resource());
 
   MCGA_DISALLOW_COPY_AND_MOVE(Parser);
 
-  ~Parser() = default;
+  ~Parser();
 
   Argument add_argument(const ArgumentSpec& spec);
 
@@ -30,22 +210,12 @@ public:
   //  Hint 1: The signature of this method should look like this:
   template<class EArg = Argument>
   ListArgument<EArg> add_list_argument(const ListArgumentSpec<EArg>& spec) {
-    check_name_availability(spec.name, spec.short_name);
-    auto argument = std::make_shared<internal::ListArgumentImpl<EArg>>(spec);
-    add_spec(argument, spec.name, spec.short_name);
-    std::string extra;
-    if (spec.default_value.has_value() && spec.implicit_value.has_value()) {
-      extra = "Default: '" + spec.default_value.value().get_description() +
-              "', Implicit: '" + spec.implicit_value.value().get_description() +
-              "'";
-    } else if (spec.default_value.has_value()) {
-      extra = "Default: '" + spec.default_value.value().get_description() + "'";
-    } else if (spec.implicit_value.has_value()) {
-      extra =
-          "Implicit: '" + spec.implicit_value.value().get_description() + "'";
-    }
-    add_help(spec.help_group, spec.name, spec.short_name, spec.description,
-             extra);
+    check_name_availability(spec.name, spec.short_name, spec.env_var);
+    auto argument =
+        internal::allocate_shared_from<internal::ListArgumentImpl<EArg>>(
+            resource, spec, resource);
+    add_spec(argument, spec.name, spec.short_name, spec.env_var);
+    help.add(internal::HelpEntry::from_spec(argument->get_spec()));
     return ListArgument<EArg>(std::move(argument));
   }
   //  Hint 2: The current behaviour of ListArgument & ListArgumentSpec should
@@ -56,12 +226,12 @@ public:
 
   template<class T>
   NumericArgument<T> add_numeric_argument(const NumericArgumentSpec& spec) {
-    check_name_availability(spec.name, spec.short_name);
-    auto argument = std::make_shared<internal::NumericArgumentImpl<T>>(spec);
-    add_spec(argument, spec.name, spec.short_name);
-    add_numeric_argument_help(spec.default_value, spec.implicit_value,
-                              spec.help_group, spec.name, spec.short_name,
-                              spec.description);
+    check_name_availability(spec.name, spec.short_name, spec.env_var);
+    auto argument =
+        internal::allocate_shared_from<internal::NumericArgumentImpl<T>>(
+            resource, spec, resource);
+    add_spec(argument, spec.name, spec.short_name, spec.env_var);
+    help.add(internal::HelpEntry::from_spec(argument->get_spec()));
     return NumericArgument<T>(std::move(argument));
   }
 
@@ -73,82 +243,309 @@ public:
 
   template<class T>
   ChoiceArgument<T> add_choice_argument(const ChoiceArgumentSpec<T>& spec) {
-    check_name_availability(spec.name, spec.short_name);
+    check_name_availability(spec.name, spec.short_name, spec.env_var);
     auto choice_argument =
-        std::make_shared<internal::ChoiceArgumentImpl<T>>(spec);
-    add_spec(choice_argument, spec.name, spec.short_name);
-    std::string rendered_options;
-    bool first = true;
-    for (const auto& option: spec.options) {
-      if (!first) {
-        rendered_options += ",";
-      }
-      first = false;
-      rendered_options += "'" + option.first + "'";
-    }
-    rendered_options = "[" + rendered_options + "]";
-    add_choice_argument_help(spec.default_value, spec.implicit_value,
-                             spec.help_group, spec.name, spec.short_name,
-                             spec.description, rendered_options);
+        internal::allocate_shared_from<internal::ChoiceArgumentImpl<T>>(
+            resource, spec, resource);
+    add_spec(choice_argument, spec.name, spec.short_name, spec.env_var);
+    const ChoiceArgumentSpec<T>& stored_spec = choice_argument->get_spec();
+    internal::HelpEntry entry = internal::HelpEntry::from_spec(stored_spec);
+    // rendered as in the error raised for an invalid value.
+    entry.allowed_values = [&table = *stored_spec.table] {
+      return "[" + table.get_rendered_keys() + "]";
+    };
+    help.add(std::move(entry));
     return ChoiceArgument<T>(std::move(choice_argument));
   }
 
+  // Replace every "@file" argument with the arguments stored in `file`, as
+  // GCC does. See internal::ResponseFiles for the format of response files.
+  void enable_response_files();
+
+  // Generate default values the first time they are read, instead of at the
+  // end of every parse, so that defaults which are never read cost nothing.
+  // Errors of the generators are then raised when reading the value, or by
+  // `resolve_all`. A deferred value can be read from several threads at once:
+  // its generator runs on the first of them, while the others wait.
+  void enable_lazy_defaults();
+
+  // Keep a generated default value for the following parses, as long as they
+  // do not set the option, instead of generating it again on every parse.
+  void keep_defaults_across_parses();
+
+  // Generate the default values that are still deferred.
+  void resolve_all() const;
+
+  // Run the generators of independent default values (see
+  // `set_independent_default_value` of the specs) concurrently, on `executor`
+  // or on an internal thread pool, when a parse or `resolve_all` needs more
+  // than one of them, and the values are allocated from a thread-safe memory
+  // resource. The other generators run afterwards, in the order of
+  // registration, and an error is raised for the first option that fails, as
+  // without concurrency. If `executor` throws, the generators it did not take
+  // run on the parsing thread, and its error is raised once all of them are
+  // done.
+  void enable_concurrent_defaults(Executor executor = {});
+
+  // Collect statistics about every parse (and streaming parse) of this
+  // parser, see `last_parse_stats`. When disabled, which is the default, a
+  // parse only checks the flag once per phase, token and lookup.
+  void enable_parse_stats(bool enabled = true);
+
+  // The statistics of the last parse, empty when collection is disabled or
+  // after a `reparse_delta`, which does not report any.
+  [[nodiscard]] const ParseStats& last_parse_stats() const;
+
+  // Read option values from a config file, see internal::ConfigFiles for the
+  // format. Every name in the file must belong to an option registered before
+  // the call. When several files set a value for the same option, the last
+  // one wins, except for list arguments, which keep all the values.
+  void load_config_file(const std::string& path);
+
+  // Options that are not in the arguments take the value of their environment
+  // variable (see `set_env_var` of the specs) when it is set, then the values
+  // of the loaded config files, in which cases they count as appeared, and
+  // their default value otherwise.
+  //
+  // Parsing keeps the memory of the options. After a first parse has warmed
+  // it up, parsing again makes no heap allocation when:
+  //  - the options are only flags and numeric arguments;
+  //  - there are no positional arguments, which are returned in a new list;
+  //  - there are no response files;
+  //  - no option reads an environment variable.
+  // Argument, choice and numeric list values reuse their memory too. The
+  // allocation tests of mcga_cli_test check this guarantee.
   ArgList parse(const ArgList& args);
+  ArgList parse(std::initializer_list<std::string_view> args);
   ArgList parse(int argc, char** argv);
-  [[nodiscard]] std::string render_help() const;
+
+  // Parse the arguments in place, without copying them. The returned
+  // positional arguments are views into `args`, so they are only valid for as
+  // long as the underlying strings are. Positional arguments read from
+  // response files are valid until the next parse.
+  ArgViewList parse(std::span<const std::string_view> args);
+  ArgViewList parse(std::span<const char* const> args);
+
+  // Like the above, with the positional arguments allocated from
+  // `positional_resource`, so that, with a parser allocating from an arena, a
+  // parse does not need the global heap.
+  PmrArgViewList parse(std::span<const std::string_view> args,
+                       std::pmr::memory_resource* positional_resource);
+
+  // Parse arguments received one at a time, e.g. from a pipe, as `parse`
+  // would parse all of them at once. `begin` resets the options, every `feed`
+  // applies the options its argument resolves, which does not need to outlive
+  // the call, and `finish` applies the pending short name and the default
+  // values, and returns the positional arguments. Any other parse abandons the
+  // streaming parse.
+  void begin();
+  void feed(std::string_view arg);
+  ArgList finish();
+
+  // Call `callback` with the value of `handle` (see `get_value_view`) during
+  // streaming parses: from `feed`, as soon as an argument gives the option a
+  // value (so once per value for list arguments), and from `finish` for
+  // options that did not appear in the arguments.
+  template<class Handle, class Callback>
+  void on_value(const Handle& handle, Callback callback) {
+    auto* option = handle.get();
+    add_value_callback(option, [option, callback = std::move(callback)] {
+      callback(option->get_value_view());
+    });
+  }
+
+  // Parse `args`, only updating the arguments whose occurrences differ from
+  // the previous call to `reparse_delta`. Arguments that are not affected keep
+  // their values, and their default values are not generated again. The final
+  // state is the same as the one `parse(args)` would produce, and so is the
+  // error reported for invalid arguments. The first call (and any call after
+  // a `parse` or a registration) is a full parse.
+  ArgList reparse_delta(const ArgList& args);
+
+  // Freeze the options registered so far into an immutable schema that can
+  // be parsed concurrently. Options registered afterwards are not part of it.
+  [[nodiscard]] std::shared_ptr<const ParserSchema> freeze();
+
+  // Validate many command lines at once, see ParserSchema::parse_batch. The
+  // options of this parser are not modified.
+  [[nodiscard]] std::vector<ParseOutcome>
+      parse_batch(std::span<const ArgList> batch);
+
+  // The help is only built the first time it is rendered, and then kept
+  // until the next option is registered.
+  [[nodiscard]] const std::string& render_help() const;
+
+  // Render the help as a table of two aligned columns, with the descriptions
+  // wrapped to fit lines of `width` characters.
+  [[nodiscard]] const std::string& render_help(std::size_t width) const;
 
 private:
   using CommandLineOptionPtr = std::shared_ptr<internal::CommandLineOption>;
 
-  struct HelpGroup {
-    std::string group_name;
-    std::string content;
+  template<class Positional>
+  class TokenHandler;
+
+  class DeltaHandler;
+
+  class StreamHandler;
+
+  struct StreamState;
+
+  // In order of priority.
+  enum class ValueSource : std::uint8_t {
+    arguments,
+    environment,
+    config_files,
   };
 
-  void add_spec(const CommandLineOptionPtr& spec, const std::string& name,
-                const std::string& short_name);
+  struct DeltaEvent {
+    std::uint32_t spec_index;
+    bool implicit;
+    std::string_view value;
+    ValueSource source;
+
+    bool operator==(const DeltaEvent& other) const = default;
+  };
 
-  void apply_value(const std::string& cliString, const std::string& value);
+  struct DeltaState {
+    ArgList args;
+    std::vector<DeltaEvent> events;
+    std::vector<std::string> env_values;
+    internal::ResponseFiles response_files;
+    bool valid = false;
+  };
 
-  void apply_implicit(const std::string& cliString);
+  // The positional arguments are appended to `positional_args`. Tokens and
+  // lookups are counted in `stats`, unless it is null.
+  template<class Args, class Positional = ArgViewList>
+  static Positional
+      apply_args(const internal::OptionIndex& index,
+                 const std::vector<CommandLineOptionPtr>& options,
+                 const Args& args, internal::ResponseFiles* response_files,
+                 ParseStats* stats, Positional positional_args = {});
 
-  [[nodiscard]] bool should_apply_value(const std::string& cliString) const;
+  template<class Args, class Positional = ArgViewList>
+  Positional parse_args(const Args& args, Positional positional_args = {});
 
-  void check_name_availability(const std::string& name,
-                               const std::string& short_name) const;
+  void build_indices();
+
+  void start_parse();
+
+  void finish_parse();
+
+  // Options that did not appear in the arguments take the value of their
+  // environment variable if it is set, then the values of the config files,
+  // and their default value otherwise.
+  static void apply_defaults(const std::vector<CommandLineOptionPtr>& options,
+                             const internal::OptionIndex* env_vars_index,
+                             const internal::ConfigFiles* config_files,
+                             const internal::ParseSettings& settings,
+                             ParseStats* stats = nullptr);
 
-  void add_choice_argument_help(
-      const std::optional<internal::Generator>& default_value,
-      const std::optional<internal::Generator>& implicit_value,
-      const std::string& help_group, const std::string& name,
-      const std::string& short_name, const std::string& description,
-      const std::string& rendered_options);
+  // Generate concurrently the independent default values that `options`
+  // need, and return the errors of the generators, ordered by option.
+  static std::vector<std::pair<std::uint32_t, std::exception_ptr>>
+      generate_independent_defaults(
+          const std::vector<CommandLineOptionPtr>& options,
+          const Executor& executor, ParseStats* stats = nullptr);
 
-  void add_numeric_argument_help(
-      const std::optional<internal::Generator>& default_value,
-      const std::optional<internal::Generator>& implicit_value,
-      const std::string& help_group, const std::string& name,
-      const std::string& short_name, const std::string& description);
+  // Generate (or defer) the default values of the options that are not set,
+  // raising the first of `errors` at its position.
+  static void generate_defaults(
+      const std::vector<CommandLineOptionPtr>& options, bool lazy,
+      const std::vector<std::pair<std::uint32_t, std::exception_ptr>>& errors,
+      ParseStats* stats = nullptr);
 
-  void add_help(const std::string& help_group, const std::string& name,
-                const std::string& short_name, const std::string& description,
-                const std::string& extra);
+  // Like `set_default_guarded`, timing the generator in `stats` if the
+  // default value is generated.
+  static void set_default_counted(internal::CommandLineOption& option,
+                                  bool lazy, ParseStats& stats);
+
+  static std::uint32_t count_lookup(std::uint32_t spec_index,
+                                    ParseStats* stats);
+
+  // The statistics of the current parse, or null when they are not collected.
+  [[nodiscard]] ParseStats* current_stats();
+
+  // Add the time elapsed since `start` to `phase_time` when collecting
+  // statistics. `start` is only read in that case.
+  void add_phase_time(std::chrono::nanoseconds& phase_time,
+                      std::chrono::steady_clock::time_point start) const;
+
+  [[nodiscard]] std::chrono::steady_clock::time_point phase_start() const;
+
+  void run_terminal_flags();
+
+  // Throws if `option` was not registered to this parser.
+  void add_value_callback(const internal::CommandLineOption* option,
+                          std::function<void()> callback);
+
+  void notify_value(std::uint32_t spec_index) const;
+
+  void replay(const DeltaEvent& event);
+
+  // Apply the events of one option that come from the source with the
+  // highest priority.
+  void replay_option(std::vector<DeltaEvent>::const_iterator begin,
+                     std::vector<DeltaEvent>::const_iterator end);
+
+  // Apply the `events` of a `reparse_delta`, sorted by option, to all the
+  // options when `full_parse`, or else to the options whose events differ
+  // from the previous call.
+  void replay_delta(const std::vector<DeltaEvent>& events, bool full_parse);
+
+  static ArgList to_arg_list(const ArgViewList& args);
+
+  void add_spec(const CommandLineOptionPtr& spec, const std::string& name,
+                const std::string& short_name, const std::string& env_var);
+
+  static void apply_value(const std::vector<CommandLineOptionPtr>& options,
+                          std::uint32_t spec_index, std::string_view value);
+
+  static void apply_implicit(const std::vector<CommandLineOptionPtr>& options,
+                             std::uint32_t spec_index);
+
+  [[nodiscard]] static bool
+      should_apply_value(const std::vector<CommandLineOptionPtr>& options,
+                         std::uint32_t spec_index);
+
+  void check_name_availability(const std::string& name,
+                               const std::string& short_name,
+                               const std::string& env_var) const;
 
   template<class T>
   static std::string to_string(const T& value) {
     return std::to_string(value);
   }
 
+  std::pmr::memory_resource* resource;
+
   // TODO(@Alexandra): Rename to options!
   std::vector<CommandLineOptionPtr> specs;
-  std::map<std::string, CommandLineOptionPtr> specs_by_cli_string;
+  internal::OptionIndex specs_by_cli_string;
+  internal::OptionIndex specs_by_env_var;
+  internal::ConfigFiles config_files;
 
-  std::string help_prefix;
-  std::vector<HelpGroup> help_sections;
+  internal::HelpTable help;
 
   std::set<std::string> reserved_names;
+  std::set<std::string> reserved_env_vars;
 
   std::vector<std::pair<Flag, std::function<void()>>> terminal_flags;
+
+  internal::ParseSettings settings;
+  internal::ResponseFiles response_files;
+
+  DeltaState delta_state;
+
+  bool collect_stats = false;
+  ParseStats stats;
+
+  // Indexed by option, empty for the options without a callback.
+  std::vector<std::function<void()>> value_callbacks;
+  std::unique_ptr<StreamState> stream;
+
+  friend class ParserSchema;
 };
 
 template<>
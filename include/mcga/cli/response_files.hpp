@@ -0,0 +1,59 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "mapped_file.hpp"
+
+namespace mcga::cli::internal {
+
+// Expands GCC-style "@file" response files. The arguments of a response file
+// are separated by whitespace, and can be quoted with single quotes (taken
+// verbatim) or double quotes, with backslash escaping the next character
+// outside single quotes. Files are memory-mapped and unquoted in place, so
+// the expanded arguments are views into the mappings, which stay alive until
+// `clear()` (or destruction). Response files can include other response files;
+// cycles are reported as errors. As with GCC, an "@file" argument naming a
+// file that cannot be opened is kept as it is.
+class ResponseFiles {
+public:
+  ResponseFiles() = default;
+
+  ResponseFiles(ResponseFiles&&) = default;
+  ResponseFiles& operator=(ResponseFiles&&) = default;
+
+  template<class Callback>
+  void expand(std::string_view arg, Callback& on_arg) {
+    if (arg.size() < 2 || arg[0] != '@') {
+      on_arg(arg);
+      return;
+    }
+    const MappedFile* file = open(arg.substr(1));
+    if (file == nullptr) {
+      on_arg(arg);
+      return;
+    }
+    std::span<char> remaining = file->contents();
+    std::string_view token;
+    while (next_token(remaining, token)) {
+      expand(token, on_arg);
+    }
+    open_files.pop_back();
+  }
+
+  void clear();
+
+  // Extract the next argument of `remaining`, unquoting it in place.
+  static bool next_token(std::span<char>& remaining, std::string_view& token);
+
+private:
+  const MappedFile* open(std::string_view path);
+
+  std::vector<std::unique_ptr<MappedFile>> files;
+  std::vector<std::filesystem::path> open_files;
+};
+
+} // namespace mcga::cli::internal
@@ -0,0 +1,426 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "choice_table.hpp"
+#include "exceptions.hpp"
+#include "numeric_argument.hpp"
+#include "tokenizer.hpp"
+
+namespace mcga::cli {
+
+// Option kinds for StaticParser. A static option is a struct deriving from one
+// of these, which declares its command-line names as compile-time constants:
+//
+//   struct Verbose: StaticFlag {
+//     static constexpr std::string_view name = "verbose";
+//     static constexpr char short_name = 'v';
+//   };
+//
+//   struct Jobs: StaticNumericArgument<int> {
+//     static constexpr std::string_view name = "jobs";
+//     static constexpr std::string_view default_value = "1";
+//   };
+//
+// `short_name`, `default_value` and `implicit_value` are optional, and can
+// also be used to override the ones of the base.
+
+struct StaticFlag {
+  using ValueType = bool;
+
+  static constexpr bool consumes_next_positional_arg = false;
+  static constexpr std::string_view default_value = "false";
+  static constexpr std::string_view implicit_value = "true";
+
+  static bool convert(std::string_view name, std::string_view value) {
+    for (const auto& option: internal::flag_values) {
+      if (internal::equals_ignoring_case(option.first, value)) {
+        return option.second;
+      }
+    }
+    internal::throw_invalid_argument_exception(
+        "Trying to set option `" + std::string(value) + "` to flag " +
+        std::string(name));
+  }
+};
+
+struct StaticArgument {
+  using ValueType = std::string_view;
+
+  static constexpr bool consumes_next_positional_arg = true;
+
+  static std::string_view convert(std::string_view /*name*/,
+                                  std::string_view value) {
+    return value;
+  }
+};
+
+template<class T>
+struct StaticNumericArgument {
+  using ValueType = T;
+
+  static constexpr bool consumes_next_positional_arg = true;
+
+  static T convert(std::string_view /*name*/, std::string_view value) {
+    return internal::from_string<T>(value);
+  }
+};
+
+// The derived option must declare its choices as
+// `static constexpr std::pair<std::string_view, T> options[] = {...};`.
+template<class Derived, class T>
+struct StaticChoiceArgument {
+  using ValueType = T;
+
+  static constexpr bool consumes_next_positional_arg = true;
+
+  static T convert(std::string_view name, std::string_view value) {
+    // Sorted at compile time, so that a lookup is a binary search.
+    static constexpr auto sorted_options =
+        internal::sort_choices(Derived::options);
+    static_assert(internal::has_unique_choices(sorted_options),
+                  "The options of a choice argument must be unique.");
+    const T* option = internal::find_choice(sorted_options, value);
+    if (option != nullptr) {
+      return *option;
+    }
+    internal::throw_invalid_argument_exception(
+        "Trying to set option `" + std::string(value) + "` to argument " +
+        std::string(name));
+  }
+};
+
+namespace internal {
+
+template<class Option>
+constexpr char static_short_name() {
+  if constexpr (requires { Option::short_name; }) {
+    return Option::short_name;
+  } else {
+    return '\0';
+  }
+}
+
+template<class Option>
+constexpr bool static_has_default_value() {
+  return requires { Option::default_value; };
+}
+
+template<class Option>
+constexpr bool static_has_implicit_value() {
+  return requires { Option::implicit_value; };
+}
+
+constexpr std::uint64_t static_hash(std::string_view key, std::uint64_t seed) {
+  std::uint64_t hash = 14695981039346656037ull ^ seed;
+  for (char c: key) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ull;
+  }
+  return hash ^ (hash >> 29);
+}
+
+// Perfect hash from the command-line names of a fixed option list to the
+// options' positions, computed entirely at compile time. Each lookup costs one
+// hash and one key comparison.
+template<std::size_t NumKeys>
+struct StaticOptionIndex {
+  static constexpr std::uint32_t npos = UINT32_MAX;
+
+  struct Entry {
+    std::string_view key;
+    std::uint32_t value = npos;
+  };
+
+  static constexpr std::size_t capacity =
+      std::bit_ceil(std::max<std::size_t>(2 * NumKeys, 8));
+
+  static constexpr std::uint64_t max_seed_attempts = 1 << 16;
+
+  std::array<Entry, capacity> slots{};
+  std::array<std::uint32_t, 256> short_slots{};
+  std::uint64_t seed = 0;
+  // False when no seed within `max_seed_attempts` places every name in its
+  // own slot, in which case some names could not be found.
+  bool found_seed = false;
+
+  constexpr StaticOptionIndex(const std::array<Entry, NumKeys>& entries) {
+    for (std::uint32_t& short_slot: short_slots) {
+      short_slot = npos;
+    }
+    for (const Entry& entry: entries) {
+      if (entry.key.size() == 1) {
+        short_slots[static_cast<unsigned char>(entry.key[0])] = entry.value;
+      }
+    }
+    // no seed separates duplicate keys, and searching through all of them
+    // would exceed the compiler's constexpr evaluation limit.
+    for (std::size_t i = 0; i < NumKeys; ++i) {
+      for (std::size_t j = i + 1; j < NumKeys; ++j) {
+        if (entries[i].key == entries[j].key) {
+          return;
+        }
+      }
+    }
+    // with a load factor of at most 1/2, a collision-free seed is found after
+    // a handful of attempts for any realistic option list. The search is
+    // bounded, so that an unlucky option list fails the static_assert of the
+    // parser instead of looping forever.
+    for (seed = 0; seed < max_seed_attempts; ++seed) {
+      for (Entry& slot: slots) {
+        slot = Entry{};
+      }
+      bool collision = false;
+      for (const Entry& entry: entries) {
+        Entry& slot = slots[static_hash(entry.key, seed) & (capacity - 1)];
+        if (slot.value != npos) {
+          collision = true;
+          break;
+        }
+        slot = entry;
+      }
+      if (!collision) {
+        found_seed = true;
+        break;
+      }
+    }
+  }
+
+  [[nodiscard]] constexpr std::uint32_t find(std::string_view key) const {
+    const Entry& slot = slots[static_hash(key, seed) & (capacity - 1)];
+    return slot.key == key ? slot.value : npos;
+  }
+
+  [[nodiscard]] constexpr std::uint32_t find_short(char key) const {
+    return short_slots[static_cast<unsigned char>(key)];
+  }
+};
+
+template<class... Options>
+struct StaticSchema {
+  static constexpr std::size_t num_names =
+      (... + (static_short_name<Options>() != '\0' ? 2 : 1));
+
+  static constexpr char short_names[] = {static_short_name<Options>()...};
+
+  template<class Option>
+  static constexpr std::size_t index_of() {
+    constexpr bool matches[] = {std::is_same_v<Option, Options>...};
+    for (std::size_t i = 0; i < sizeof...(Options); ++i) {
+      if (matches[i]) {
+        return i;
+      }
+    }
+    return sizeof...(Options);
+  }
+
+  static constexpr auto names() {
+    std::array<typename StaticOptionIndex<num_names>::Entry, num_names>
+        entries{};
+    std::size_t pos = 0;
+    std::uint32_t option_index = 0;
+    auto add_names = [&](std::string_view name) {
+      entries[pos++] = {name, option_index};
+      if (short_names[option_index] != '\0') {
+        entries[pos++] = {std::string_view(&short_names[option_index], 1),
+                          option_index};
+      }
+      ++option_index;
+    };
+    (add_names(Options::name), ...);
+    return entries;
+  }
+
+  static constexpr bool has_duplicate_names() {
+    auto entries = names();
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      for (std::size_t j = i + 1; j < entries.size(); ++j) {
+        if (entries[i].key == entries[j].key) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+};
+
+} // namespace internal
+
+// Parser for a command-line schema fixed at compile time. Names are checked
+// for duplicates with static_assert, lookups go through a compile-time perfect
+// hash, and values are stored in a plain struct, without heap allocations or
+// virtual calls. Arguments are tokenized exactly like Parser does.
+template<class... Options>
+class StaticParser {
+  using Schema = internal::StaticSchema<Options...>;
+
+  static constexpr std::size_t num_options = sizeof...(Options);
+
+  static_assert(num_options > 0, "StaticParser needs at least one option.");
+  static_assert(!Schema::has_duplicate_names(),
+                "Two options of the StaticParser have the same command-line "
+                "name.");
+
+  static constexpr internal::StaticOptionIndex<Schema::num_names> index{
+      Schema::names()};
+  // duplicate names never get a seed, and are already reported above.
+  static_assert(Schema::has_duplicate_names() || index.found_seed,
+                "No perfect hash was found for the command-line names of the "
+                "StaticParser.");
+
+public:
+  using ArgViewList = std::vector<std::string_view>;
+
+  struct Values {
+    std::tuple<typename Options::ValueType...> values{};
+    std::array<bool, num_options> appeared_in_args{};
+
+    template<class Option>
+    [[nodiscard]] const typename Option::ValueType& get() const {
+      return std::get<Schema::template index_of<Option>()>(values);
+    }
+
+    template<class Option>
+    [[nodiscard]] bool appeared() const {
+      return appeared_in_args[Schema::template index_of<Option>()];
+    }
+  };
+
+  // Parse `args` into `values`, reporting every positional argument to
+  // `on_positional` as a view into `args`.
+  template<class Args, class PositionalCallback>
+  static void parse(const Args& args, Values& values,
+                    PositionalCallback&& on_positional) {
+    values.appeared_in_args.fill(false);
+    TokenHandler<PositionalCallback> handler{values, on_positional};
+    internal::Tokenizer<TokenHandler<PositionalCallback>> tokenizer(handler);
+    for (std::string_view arg: args) {
+      tokenizer.feed(arg);
+    }
+    tokenizer.finish();
+    apply_defaults(values, std::make_index_sequence<num_options>());
+  }
+
+  template<class Args>
+  static ArgViewList parse(const Args& args, Values& values) {
+    ArgViewList positional_args;
+    parse(args, values, [&](std::string_view arg) {
+      positional_args.push_back(arg);
+    });
+    return positional_args;
+  }
+
+  static ArgViewList parse(std::initializer_list<std::string_view> args,
+                           Values& values) {
+    return parse<std::initializer_list<std::string_view>>(args, values);
+  }
+
+private:
+  template<class PositionalCallback>
+  struct TokenHandler {
+    Values& values;
+    PositionalCallback& positional_callback;
+
+    void on_positional(std::string_view arg) {
+      positional_callback(arg);
+    }
+
+    void on_value(std::string_view name, std::string_view value) {
+      apply_value(values, index.find(name), value);
+    }
+
+    void on_implicit(std::string_view name) {
+      apply_implicit(values, index.find(name));
+    }
+
+    void on_short_value(char name, std::string_view value) {
+      apply_value(values, index.find_short(name), value);
+    }
+
+    void on_short_implicit(char name) {
+      apply_implicit(values, index.find_short(name));
+    }
+
+    bool consumes_short_value(char name) {
+      return consumes_value(index.find_short(name),
+                            std::make_index_sequence<num_options>());
+    }
+  };
+
+  template<std::size_t... I>
+  static bool consumes_value(std::uint32_t option_index,
+                             std::index_sequence<I...>) {
+    return (... || (option_index == I &&
+                    Options::consumes_next_positional_arg));
+  }
+
+  static void apply_value(Values& values, std::uint32_t option_index,
+                          std::string_view value) {
+    apply_at(option_index, std::make_index_sequence<num_options>(),
+             [&]<std::size_t I>() {
+               set<I>(values, value);
+             });
+  }
+
+  static void apply_implicit(Values& values, std::uint32_t option_index) {
+    apply_at(option_index, std::make_index_sequence<num_options>(),
+             [&]<std::size_t I>() {
+               using Option = std::tuple_element_t<I, std::tuple<Options...>>;
+               if constexpr (internal::static_has_implicit_value<Option>()) {
+                 set<I>(values, Option::implicit_value);
+               } else {
+                 internal::throw_invalid_argument_exception(
+                     "Trying to set implicit value for argument " +
+                     std::string(Option::name) +
+                     ", which has no implicit value.");
+               }
+             });
+  }
+
+  template<std::size_t... I, class Fn>
+  static void apply_at(std::uint32_t option_index, std::index_sequence<I...>,
+                       Fn&& fn) {
+    (void) (... || (option_index == I &&
+                    (fn.template operator()<I>(), true)));
+  }
+
+  template<std::size_t I>
+  static void set(Values& values, std::string_view value) {
+    using Option = std::tuple_element_t<I, std::tuple<Options...>>;
+    std::get<I>(values.values) = Option::convert(Option::name, value);
+    values.appeared_in_args[I] = true;
+  }
+
+  template<std::size_t... I>
+  static void apply_defaults(Values& values, std::index_sequence<I...>) {
+    (apply_default<I>(values), ...);
+  }
+
+  template<std::size_t I>
+  static void apply_default(Values& values) {
+    using Option = std::tuple_element_t<I, std::tuple<Options...>>;
+    if (values.appeared_in_args[I]) {
+      return;
+    }
+    if constexpr (internal::static_has_default_value<Option>()) {
+      std::get<I>(values.values) =
+          Option::convert(Option::name, Option::default_value);
+    } else {
+      internal::throw_invalid_argument_exception(
+          "Trying to set default value for argument " +
+          std::string(Option::name) + ", which has no default value.");
+    }
+  }
+};
+
+} // namespace mcga::cli
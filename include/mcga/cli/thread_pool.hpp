@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "disallow_copy_and_move.hpp"
+
+namespace mcga::cli::internal {
+
+// Work-stealing thread pool. Every worker owns a task queue: it runs its own
+// tasks newest-first, and when it runs out it steals the oldest task of
+// another worker, so uneven tasks still keep all workers busy.
+class ThreadPool {
+public:
+  explicit ThreadPool(std::size_t num_threads);
+
+  MCGA_DISALLOW_COPY_AND_MOVE(ThreadPool);
+
+  // Runs every task submitted so far before returning.
+  ~ThreadPool();
+
+  void submit(std::function<void()> task);
+
+  [[nodiscard]] std::size_t size() const;
+
+  // Pool with one worker per hardware thread, created on first use.
+  static ThreadPool& shared();
+
+private:
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void run_worker(std::size_t worker_id);
+
+  bool try_pop(std::size_t worker_id, std::function<void()>& task);
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues;
+  std::vector<std::thread> threads;
+  std::atomic<std::size_t> next_queue = 0;
+
+  std::mutex sleep_mutex;
+  std::condition_variable wake_up;
+  std::size_t num_pending = 0;
+  bool stopping = false;
+};
+
+} // namespace mcga::cli::internal
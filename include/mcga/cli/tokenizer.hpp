@@ -0,0 +1,107 @@
+#pragma once
+
+#include <string_view>
+
+namespace mcga::cli::internal {
+
+// Single-pass classifier for command-line arguments. Each argument is scanned
+// once, left to right, and reported to the handler without building any
+// temporary strings:
+//  - "--" makes every following argument positional.
+//  - "--X" gives argument "X" its implicit value.
+//  - "--X=v" gives argument "X" value "v".
+//  - "-XYZ" gives "X" and "Y" their implicit values, and leaves "Z" pending,
+//    as "-XYZ v" is equivalent with "--X --Y --Z=v".
+//  - "-XYZ=v" gives "X" and "Y" their implicit values and "Z" value "v".
+//  - anything else (including "-") is either the value of the pending short
+//    name, or a positional argument.
+//
+// The handler must provide:
+//  - void on_positional(std::string_view arg);
+//  - void on_value(std::string_view name, std::string_view value);
+//  - void on_implicit(std::string_view name);
+//  - void on_short_value(char name, std::string_view value);
+//  - void on_short_implicit(char name);
+//  - bool consumes_short_value(char name);
+template<class Handler>
+class Tokenizer {
+public:
+  explicit Tokenizer(Handler& handler_): handler(handler_) {}
+
+  void feed(std::string_view arg) {
+    if (arg.size() == 2 && arg[0] == '-' && arg[1] == '-') {
+      only_positional = true;
+      return;
+    }
+
+    if (only_positional) {
+      handler.on_positional(arg);
+      return;
+    }
+
+    if (arg.empty() || arg[0] != '-' || arg.size() == 1) {
+      if (has_pending_short_name &&
+          handler.consumes_short_value(pending_short_name)) {
+        has_pending_short_name = false;
+        handler.on_short_value(pending_short_name, arg);
+      } else {
+        handler.on_positional(arg);
+      }
+      return;
+    }
+
+    // a special argument never fulfills the pending short name, so it takes
+    // its implicit value.
+    flush_pending_short_name();
+
+    if (arg[1] == '-') {
+      std::string_view name_and_value = arg.substr(2);
+      auto equal_pos = name_and_value.find('=');
+      if (equal_pos == std::string_view::npos) {
+        handler.on_implicit(name_and_value);
+      } else {
+        handler.on_value(name_and_value.substr(0, equal_pos),
+                         name_and_value.substr(equal_pos + 1));
+      }
+      return;
+    }
+
+    // "-=v" names the argument by the character preceding the equal sign,
+    // which is the dash itself.
+    if (arg[1] == '=') {
+      handler.on_short_value(arg[0], arg.substr(2));
+      return;
+    }
+
+    for (std::size_t j = 1; j < arg.size(); ++j) {
+      if (j + 1 == arg.size()) {
+        pending_short_name = arg[j];
+        has_pending_short_name = true;
+      } else if (arg[j + 1] == '=') {
+        handler.on_short_value(arg[j], arg.substr(j + 2));
+        return;
+      } else {
+        handler.on_short_implicit(arg[j]);
+      }
+    }
+  }
+
+  void finish() {
+    flush_pending_short_name();
+  }
+
+private:
+  void flush_pending_short_name() {
+    if (has_pending_short_name) {
+      has_pending_short_name = false;
+      handler.on_short_implicit(pending_short_name);
+    }
+  }
+
+  Handler& handler;
+  char pending_short_name = 0;
+  bool has_pending_short_name = false;
+  bool only_positional = false;
+};
+
+} // namespace mcga::cli::internal
@@ -19,6 +19,11 @@ ArgumentSpec& ArgumentSpec::set_short_name(std::string short_name_) {
   return *this;
 }
 
+ArgumentSpec& ArgumentSpec::set_env_var(std::string env_var_) {
+  env_var = std::move(env_var_);
+  return *this;
+}
+
 ArgumentSpec&
     ArgumentSpec::set_default_value(const std::string& default_value_) {
   default_value.emplace(
@@ -36,6 +41,11 @@ ArgumentSpec& ArgumentSpec::set_default_value_generator(
   return *this;
 }
 
+ArgumentSpec& ArgumentSpec::set_independent_default_value(bool independent) {
+  independent_default_value = independent;
+  return *this;
+}
+
 ArgumentSpec&
     ArgumentSpec::set_implicit_value(const std::string& implicit_value_) {
   implicit_value.emplace(
@@ -60,31 +70,56 @@ std::optional<std::string> ArgumentImpl::get_value_if_exists() const {
 }
 
 std::string ArgumentImpl::get_value() const {
+  return std::string(get_value_view());
+}
+
+std::string_view ArgumentImpl::get_value_view() const {
+  resolve_default();
   return value;
 }
 
+std::optional<std::string_view> ArgumentImpl::get_value_view_if_exists() const {
+  return appeared() ? std::optional<std::string_view>{get_value_view()}
+                    : std::nullopt;
+}
+
 const ArgumentSpec& ArgumentImpl::get_spec() const {
-  return spec;
+  return *spec;
 }
 
-ArgumentImpl::ArgumentImpl(const ArgumentSpec& spec)
-    : CommandLineOption(spec.default_value.has_value(),
-                        spec.implicit_value.has_value()),
-      spec(spec) {}
+ArgumentImpl::ArgumentImpl(const ArgumentSpec& spec,
+                           std::pmr::memory_resource* resource_)
+    : ArgumentImpl(
+          allocate_shared_from<const ArgumentSpec>(resource_, spec),
+          resource_) {}
+
+ArgumentImpl::ArgumentImpl(std::shared_ptr<const ArgumentSpec> spec,
+                           std::pmr::memory_resource* resource_)
+    : CommandLineOption(spec->default_value.has_value(),
+                        spec->implicit_value.has_value(),
+                        spec->independent_default_value, resource_),
+      spec(std::move(spec)),
+      value(resource_) {}
+
+std::shared_ptr<CommandLineOption> ArgumentImpl::create_instance(
+    std::pmr::memory_resource* instance_resource) const {
+  return allocate_shared_from<ArgumentImpl>(instance_resource, spec,
+                                            instance_resource);
+}
 
 const std::string& ArgumentImpl::get_name() const {
-  return spec.name;
+  return spec->name;
 }
 
 void ArgumentImpl::set_default() {
-  value = spec.default_value.value().generate();
+  value = spec->default_value.value().generate();
 }
 
 void ArgumentImpl::set_implicit() {
-  value = spec.implicit_value.value().generate();
+  value = spec->implicit_value.value().generate();
 }
 
-void ArgumentImpl::set_value(const std::string& value_) {
+void ArgumentImpl::set_value(std::string_view value_) {
   value = value_;
 }
 
@@ -4,14 +4,25 @@
 
 namespace mcga::cli::internal {
 
+bool is_synchronized(const std::pmr::memory_resource* resource) {
+  return resource == std::pmr::new_delete_resource() ||
+         resource == std::pmr::null_memory_resource() ||
+         dynamic_cast<const std::pmr::synchronized_pool_resource*>(resource) !=
+             nullptr;
+}
+
 bool CommandLineOption::appeared() const {
   return appeared_in_args;
 }
 
 CommandLineOption::CommandLineOption(bool has_default_value_,
-                                     bool has_implicit_value_)
-    : has_default_value(has_default_value_),
-      has_implicit_value(has_implicit_value_) {}
+                                     bool has_implicit_value_,
+                                     bool independent_default_value_,
+                                     std::pmr::memory_resource* resource_)
+    : resource(resource_),
+      has_default_value(has_default_value_),
+      has_implicit_value(has_implicit_value_),
+      independent_default_value(independent_default_value_) {}
 
 bool CommandLineOption::consumes_next_positional_arg() const {
   return true;
@@ -19,16 +30,41 @@ bool CommandLineOption::consumes_next_positional_arg() const {
 
 void CommandLineOption::reset() {
   appeared_in_args = false;
+  default_state.store(DefaultState::none, std::memory_order_relaxed);
+}
+
+void CommandLineOption::resolve_default() const {
+  // the acquire load pairs with the release store below, so a reader that
+  // sees the value generated also sees the value.
+  if (default_state.load(std::memory_order_acquire) !=
+      DefaultState::deferred) {
+    return;
+  }
+  std::lock_guard guard(resolve_mutex);
+  if (default_state.load(std::memory_order_relaxed) ==
+      DefaultState::deferred) {
+    // options are never created const, so their value can be generated here.
+    const_cast<CommandLineOption*>(this)->set_default();
+    default_state.store(DefaultState::generated, std::memory_order_release);
+  }
 }
 
-void CommandLineOption::set_default_guarded() {
+void CommandLineOption::set_default_guarded(bool lazy) {
   if (!has_default_value) {
     internal::throw_invalid_argument_exception(
         "Trying to set default value for argument " + get_name() +
         ", which has no default value.");
   }
-  set_default();
   appeared_in_args = false;
+  if (default_state != DefaultState::none) {
+    return;
+  }
+  if (lazy) {
+    default_state.store(DefaultState::deferred, std::memory_order_relaxed);
+    return;
+  }
+  set_default();
+  default_state.store(DefaultState::generated, std::memory_order_relaxed);
 }
 
 void CommandLineOption::set_implicit_guarded() {
@@ -37,11 +73,19 @@ void CommandLineOption::set_implicit_guarded() {
         "Trying to set implicit value for argument " + get_name() +
         ", which has no implicit value.");
   }
+  if (default_state != DefaultState::none) {
+    reset();
+  }
   set_implicit();
   appeared_in_args = true;
 }
 
-void CommandLineOption::set_value_guarded(const std::string& value) {
+void CommandLineOption::set_value_guarded(std::string_view value) {
+  // a value that outlived its parse (see `set_default_guarded`) is dropped
+  // first, so that list arguments do not append to it.
+  if (default_state != DefaultState::none) {
+    reset();
+  }
   set_value(value);
   appeared_in_args = true;
 }
@@ -0,0 +1,114 @@
+#include <mcga/cli/config_files.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+#include <mcga/cli/exceptions.hpp>
+
+namespace mcga::cli::internal {
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+  while (!text.empty() &&
+         std::isspace(static_cast<unsigned char>(text.front())) != 0) {
+    text.remove_prefix(1);
+  }
+  while (!text.empty() &&
+         std::isspace(static_cast<unsigned char>(text.back())) != 0) {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+
+std::string_view unquote(std::string_view value) {
+  if (value.size() >= 2 && (value.front() == '"' || value.front() == '\'') &&
+      value.back() == value.front()) {
+    return value.substr(1, value.size() - 2);
+  }
+  return value;
+}
+
+} // namespace
+
+void ConfigFiles::load(const std::filesystem::path& path,
+                       const OptionIndex& index) {
+  // entries are only added once all the files are read, so that a file with
+  // an error leaves this object unchanged.
+  ConfigFiles loaded;
+  std::vector<std::filesystem::path> open_files;
+  loaded.load_file(path, index, open_files);
+  files.insert(files.end(), loaded.files.begin(), loaded.files.end());
+  entries.insert(entries.end(), loaded.entries.begin(), loaded.entries.end());
+  // the entries of an option are applied together, so they are grouped by
+  // option, keeping the order of the files.
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](const ConfigEntry& lhs, const ConfigEntry& rhs) {
+                     return lhs.option_index < rhs.option_index;
+                   });
+}
+
+const std::vector<ConfigEntry>& ConfigFiles::get_entries() const {
+  return entries;
+}
+
+void ConfigFiles::load_file(const std::filesystem::path& path,
+                            const OptionIndex& index,
+                            std::vector<std::filesystem::path>& open_files) {
+  std::error_code error;
+  std::filesystem::path file_path = std::filesystem::canonical(path, error);
+  if (error) {
+    throw_invalid_argument_exception("Could not open config file " +
+                                     path.string());
+  }
+  if (std::find(open_files.begin(), open_files.end(), file_path) !=
+      open_files.end()) {
+    throw_invalid_argument_exception("Config file " + file_path.string() +
+                                     " includes itself.");
+  }
+  auto file = std::make_shared<const MappedFile>(file_path);
+  files.push_back(file);
+  open_files.push_back(file_path);
+
+  std::span<char> contents = file->contents();
+  std::string_view remaining(contents.data(), contents.size());
+  std::size_t line_number = 0;
+  while (!remaining.empty()) {
+    std::size_t line_end = remaining.find('\n');
+    std::string_view line = trim(remaining.substr(0, line_end));
+    remaining.remove_prefix(
+        line_end == std::string_view::npos ? remaining.size() : line_end + 1);
+    line_number += 1;
+    if (line.empty() || line.front() == '#' || line.front() == ';') {
+      continue;
+    }
+
+    std::size_t separator = line.find('=');
+    std::string_view name = trim(line.substr(0, separator));
+    if (separator == std::string_view::npos && name.starts_with("include") &&
+        name.size() > 7 && std::isspace(static_cast<unsigned char>(name[7]))) {
+      std::filesystem::path included(unquote(trim(name.substr(7))));
+      load_file(included.is_absolute() ? included
+                                       : file_path.parent_path() / included,
+                index, open_files);
+      continue;
+    }
+
+    std::uint32_t option_index = index.find(name);
+    if (option_index == OptionIndex::npos) {
+      throw_invalid_argument_exception(
+          "Unknown option `" + std::string(name) + "` in config file " +
+          file_path.string() + ":" + std::to_string(line_number));
+    }
+    if (separator == std::string_view::npos) {
+      entries.push_back({option_index, true, {}});
+    } else {
+      entries.push_back(
+          {option_index, false, unquote(trim(line.substr(separator + 1)))});
+    }
+  }
+  open_files.pop_back();
+}
+
+} // namespace mcga::cli::internal
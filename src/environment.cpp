@@ -0,0 +1,32 @@
+#include <mcga/cli/environment.hpp>
+
+#include <cstring>
+
+#ifdef _WIN32
+#include <stdlib.h>
+#define MCGA_CLI_ENVIRON _environ
+#else
+extern "C" char** environ;
+#define MCGA_CLI_ENVIRON environ
+#endif
+
+namespace mcga::cli::internal {
+
+std::vector<EnvironmentValue> read_environment(const OptionIndex& env_vars) {
+  std::vector<EnvironmentValue> values;
+  for (char** entry = MCGA_CLI_ENVIRON; entry != nullptr && *entry != nullptr;
+       ++entry) {
+    const char* separator = std::strchr(*entry, '=');
+    if (separator == nullptr) {
+      continue;
+    }
+    std::uint32_t option_index = env_vars.find(
+        std::string_view(*entry, static_cast<std::size_t>(separator - *entry)));
+    if (option_index != OptionIndex::npos) {
+      values.push_back({option_index, std::string_view(separator + 1)});
+    }
+  }
+  return values;
+}
+
+} // namespace mcga::cli::internal
@@ -19,26 +19,54 @@ FlagSpec& FlagSpec::set_short_name(std::string short_name_) {
   return *this;
 }
 
+FlagSpec& FlagSpec::set_env_var(std::string env_var_) {
+  env_var = std::move(env_var_);
+  return *this;
+}
+
 namespace internal {
 
-FlagImpl::FlagImpl(const FlagSpec& spec)
-    : internal::ChoiceArgumentImpl<bool>(ChoiceArgumentSpec<bool>(spec.name)
-                                             .set_short_name(spec.short_name)
-                                             .set_description(spec.description)
-                                             .set_help_group(spec.help_group)
-                                             .set_options({{"1", true},
-                                                           {"true", true},
-                                                           {"TRUE", true},
-                                                           {"enabled", true},
-                                                           {"ENABLED", true},
-
-                                                           {"0", false},
-                                                           {"false", false},
-                                                           {"FALSE", false},
-                                                           {"disabled", false},
-                                                           {"DISABLED", false}})
-                                             .set_default_value("false")
-                                             .set_implicit_value("true")) {}
+namespace {
+
+// All flags share the same immutable table of values.
+const std::shared_ptr<const ChoiceTable<bool>>& flag_values_table() {
+  static const auto table = std::make_shared<const ChoiceTable<bool>>(
+      flag_values, /*case_insensitive_=*/true);
+  return table;
+}
+
+// The spec of every flag points at the shared table, which also holds the
+// accepted values listed by `get_spec().get_options()`.
+ChoiceArgumentSpec<bool> flag_choice_spec(const FlagSpec& spec) {
+  ChoiceArgumentSpec<bool> choice_spec(spec.name);
+  choice_spec.set_short_name(spec.short_name)
+      .set_description(spec.description)
+      .set_help_group(spec.help_group)
+      .set_env_var(spec.env_var)
+      .set_case_insensitive()
+      .set_default_value("false")
+      .set_implicit_value("true");
+  choice_spec.table = flag_values_table();
+  return choice_spec;
+}
+
+} // namespace
+
+FlagImpl::FlagImpl(const FlagSpec& spec, std::pmr::memory_resource* resource_)
+    : internal::ChoiceArgumentImpl<bool>(
+          allocate_shared_from<const ChoiceArgumentSpec<bool>>(
+              resource_, flag_choice_spec(spec)),
+          resource_) {}
+
+FlagImpl::FlagImpl(std::shared_ptr<const ChoiceArgumentSpec<bool>> spec,
+                   std::pmr::memory_resource* resource_)
+    : internal::ChoiceArgumentImpl<bool>(std::move(spec), resource_) {}
+
+std::shared_ptr<CommandLineOption> FlagImpl::create_instance(
+    std::pmr::memory_resource* instance_resource) const {
+  return allocate_shared_from<FlagImpl>(instance_resource, spec,
+                                        instance_resource);
+}
 
 bool FlagImpl::consumes_next_positional_arg() const {
   return false;
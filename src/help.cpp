@@ -0,0 +1,224 @@
+#include <mcga/cli/help.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string_view>
+#include <unordered_map>
+
+#if __has_include(<sys/ioctl.h>) && __has_include(<unistd.h>)
+#include <sys/ioctl.h>
+#include <unistd.h>
+#define MCGA_CLI_HAS_IOCTL
+#endif
+
+namespace mcga::cli::internal {
+
+namespace {
+
+constexpr std::size_t min_column = 4;
+
+std::string render_names(const HelpEntry& entry) {
+  std::string names = "--" + *entry.name;
+  if (!entry.short_name->empty()) {
+    names += ",-" + *entry.short_name;
+  }
+  return names;
+}
+
+// Append `text` to `out`, wrapped to lines of at most `width` characters
+// indented by `indent` spaces. The first line continues the current one,
+// which is assumed to already be indented. Words longer than a line are kept
+// whole.
+void append_wrapped(std::string& out, std::string_view text,
+                    std::size_t indent, std::size_t width) {
+  std::size_t line_length = 0;
+  while (!text.empty()) {
+    std::size_t word_begin = text.find_first_not_of(' ');
+    if (word_begin == std::string_view::npos) {
+      break;
+    }
+    text.remove_prefix(word_begin);
+    std::string_view word = text.substr(0, text.find(' '));
+    text.remove_prefix(word.size());
+    if (line_length != 0 && line_length + 1 + word.size() > width) {
+      out += '\n';
+      out.append(indent, ' ');
+      line_length = 0;
+    } else if (line_length != 0) {
+      out += ' ';
+      ++line_length;
+    }
+    out += word;
+    line_length += word.size();
+  }
+}
+
+} // namespace
+
+HelpTable::HelpTable(std::string prefix_, std::pmr::memory_resource* resource)
+    : prefix(std::move(prefix_)), entries(resource) {}
+
+void HelpTable::add(HelpEntry entry) {
+  entries.push_back(std::move(entry));
+  has_cached_help = false;
+  cached_table_width = 0;
+}
+
+std::string HelpTable::render_extra(const HelpEntry& entry) {
+  std::string extra;
+  if (entry.default_description != nullptr) {
+    extra = "Default: '" + *entry.default_description + "'";
+  }
+  if (entry.implicit_description != nullptr) {
+    if (!extra.empty()) {
+      extra += ", ";
+    }
+    extra += "Implicit: '" + *entry.implicit_description + "'";
+  }
+  if (!extra.empty() && entry.allowed_values) {
+    extra += ", allowed values: " + entry.allowed_values();
+  }
+  return extra;
+}
+
+auto HelpTable::group_entries() const -> std::vector<Group> {
+  std::vector<Group> groups{{nullptr, {}}};
+  std::unordered_map<std::string_view, std::size_t> group_positions;
+  for (const HelpEntry& entry: entries) {
+    std::size_t position = 0;
+    if (!entry.group->empty()) {
+      auto [it, inserted] =
+          group_positions.try_emplace(*entry.group, groups.size());
+      if (inserted) {
+        groups.push_back({entry.group, {}});
+      }
+      position = it->second;
+    }
+    groups[position].entries.push_back(&entry);
+  }
+  return groups;
+}
+
+const std::string& HelpTable::render() const {
+  if (has_cached_help) {
+    return cached_help;
+  }
+  std::string help = prefix + "\n";
+  bool first_group = true;
+  for (const Group& group: group_entries()) {
+    if (!first_group) {
+      help += '\n';
+      help += *group.name;
+      help += '\n';
+    }
+    for (const HelpEntry* entry: group.entries) {
+      if (first_group) {
+        help += "\n";
+      }
+      help += '\t';
+      help += render_names(*entry);
+      if (!entry->description->empty()) {
+        help += "  ";
+        help += *entry->description;
+      }
+      std::string extra = render_extra(*entry);
+      if (!extra.empty()) {
+        help += entry->description->empty() ? "  " : "\n\t\t";
+        help += extra;
+      }
+      if (!first_group) {
+        help += "\n";
+      }
+    }
+    if (first_group) {
+      help += "\n";
+    }
+    first_group = false;
+  }
+  cached_help = std::move(help);
+  has_cached_help = true;
+  return cached_help;
+}
+
+const std::string& HelpTable::render(std::size_t width) const {
+  width = std::max<std::size_t>(width, 1);
+  if (cached_table_width == width) {
+    return cached_table;
+  }
+
+  // The names column is as wide as the longest names, up to half of the
+  // width. Longer names push their description to the next line.
+  std::size_t max_column = std::max<std::size_t>(width / 2, min_column);
+  std::size_t column = 0;
+  for (const HelpEntry& entry: entries) {
+    std::size_t names_column = 2 + render_names(entry).size() + 2;
+    if (names_column <= max_column) {
+      column = std::max(column, names_column);
+    }
+  }
+  if (column == 0) {
+    column = max_column;
+  }
+  std::size_t description_width = width > column ? width - column : 1;
+
+  std::string table = prefix + "\n";
+  for (const Group& group: group_entries()) {
+    if (group.entries.empty()) {
+      continue;
+    }
+    table += "\n";
+    if (group.name != nullptr) {
+      table += *group.name + "\n";
+    }
+    for (const HelpEntry* entry: group.entries) {
+      std::string names = "  " + render_names(*entry);
+      table += names;
+      std::string extra = render_extra(*entry);
+      if (entry->description->empty() && extra.empty()) {
+        table += "\n";
+        continue;
+      }
+      if (names.size() + 2 > column) {
+        table += "\n";
+        table.append(column, ' ');
+      } else {
+        table.append(column - names.size(), ' ');
+      }
+      bool has_description = !entry->description->empty();
+      if (has_description) {
+        append_wrapped(table, *entry->description, column, description_width);
+      }
+      if (!extra.empty()) {
+        if (has_description) {
+          table += "\n";
+          table.append(column, ' ');
+        }
+        append_wrapped(table, extra, column, description_width);
+      }
+      table += "\n";
+    }
+  }
+  cached_table = std::move(table);
+  cached_table_width = width;
+  return cached_table;
+}
+
+std::size_t HelpTable::terminal_width() {
+#ifdef MCGA_CLI_HAS_IOCTL
+  winsize size{};
+  if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col != 0) {
+    return size.ws_col;
+  }
+#endif
+  const char* columns = std::getenv("COLUMNS");
+  if (columns != nullptr) {
+    char* end = nullptr;
+    unsigned long value = std::strtoul(columns, &end, 10);
+    if (end != columns && *end == '\0' && value != 0) {
+      return value;
+    }
+  }
+  return 80;
+}
+
+} // namespace mcga::cli::internal
@@ -0,0 +1,76 @@
+#include <mcga/cli/mapped_file.hpp>
+
+#include <fstream>
+
+#include <mcga/cli/exceptions.hpp>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MCGA_CLI_HAS_MMAP
+#endif
+
+namespace mcga::cli::internal {
+
+#ifdef MCGA_CLI_HAS_MMAP
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw_invalid_argument_exception("Could not open file " +
+                                     path.string());
+  }
+  struct stat file_stat {};
+  if (::fstat(fd, &file_stat) != 0) {
+    ::close(fd);
+    throw_invalid_argument_exception("Could not read file " +
+                                     path.string());
+  }
+  size = static_cast<std::size_t>(file_stat.st_size);
+  if (size > 0) {
+    void* mapping =
+        ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      ::close(fd);
+      throw_invalid_argument_exception("Could not map file " +
+                                       path.string());
+    }
+    ::madvise(mapping, size, MADV_SEQUENTIAL);
+    data = static_cast<char*>(mapping);
+  }
+  ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data != nullptr) {
+    ::munmap(data, size);
+  }
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    throw_invalid_argument_exception("Could not open file " +
+                                     path.string());
+  }
+  size = static_cast<std::size_t>(in.tellg());
+  data = new char[size];
+  in.seekg(0);
+  in.read(data, static_cast<std::streamsize>(size));
+}
+
+MappedFile::~MappedFile() {
+  delete[] data;
+}
+
+#endif
+
+std::span<char> MappedFile::contents() const {
+  return {data, size};
+}
+
+} // namespace mcga::cli::internal
@@ -1,5 +1,17 @@
 #include <mcga/cli/numeric_argument.hpp>
 
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <type_traits>
+
+#include <mcga/cli/exceptions.hpp>
+
 namespace mcga::cli {
 
 NumericArgumentSpec::NumericArgumentSpec(std::string name_)
@@ -23,6 +35,11 @@ NumericArgumentSpec&
   return *this;
 }
 
+NumericArgumentSpec& NumericArgumentSpec::set_env_var(std::string env_var_) {
+  env_var = std::move(env_var_);
+  return *this;
+}
+
 NumericArgumentSpec&
     NumericArgumentSpec::set_default_value(const std::string& default_value_) {
   default_value.emplace(
@@ -40,6 +57,12 @@ NumericArgumentSpec& NumericArgumentSpec::set_default_value_generator(
   return *this;
 }
 
+NumericArgumentSpec&
+    NumericArgumentSpec::set_independent_default_value(bool independent) {
+  independent_default_value = independent;
+  return *this;
+}
+
 NumericArgumentSpec& NumericArgumentSpec::set_implicit_value(
     const std::string& implicit_value_) {
   implicit_value.emplace(
@@ -59,71 +82,331 @@ NumericArgumentSpec& NumericArgumentSpec::set_implicit_value_generator(
 
 namespace internal {
 
+namespace {
+
+// Whether the 8 bytes of `chunk` are all ASCII digits.
+bool is_eight_digits(std::uint64_t chunk) {
+  return ((chunk & 0xF0F0F0F0F0F0F0F0ULL) |
+          (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+         0x3333333333333333ULL;
+}
+
+// Convert the 8 ASCII digits of `chunk`, the first one in the lowest byte, in
+// three multiplications instead of eight.
+std::uint64_t parse_eight_digits(std::uint64_t chunk) {
+  chunk -= 0x3030303030303030ULL;
+  chunk = (chunk * 10) + (chunk >> 8);
+  return (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+          (((chunk >> 16) & 0x000000FF000000FFULL) *
+           (1 + (10000ULL << 32)))) >>
+         32;
+}
+
+std::uint32_t load_four_bytes(const char* data) {
+  std::uint32_t bytes = 0;
+  std::memcpy(&bytes, data, sizeof(bytes));
+  return bytes;
+}
+
+// Load the `size` (between 1 and 8) bytes at `data` with fixed-size,
+// possibly overlapping, loads which do not depend on the length, into a chunk
+// with the first byte in the lowest byte, padded with leading '0's.
+std::uint64_t load_digits(const char* data, std::size_t size) {
+  std::uint64_t chunk = 0;
+  if (size >= 4) {
+    std::uint64_t last_bytes = load_four_bytes(data + size - 4);
+    chunk = load_four_bytes(data) | (last_bytes << (8 * (size - 4)));
+  } else {
+    chunk = std::uint64_t{static_cast<unsigned char>(data[0])} |
+            (std::uint64_t{static_cast<unsigned char>(data[size / 2])}
+             << (8 * (size / 2))) |
+            (std::uint64_t{static_cast<unsigned char>(data[size - 1])}
+             << (8 * (size - 1)));
+  }
+  if (size < 8) {
+    chunk = (chunk << (8 * (8 - size))) | (0x3030303030303030ULL >> (8 * size));
+  }
+  return chunk;
+}
+
+// Decimal numbers of up to 16 digits, which covers most values given on a
+// command line, are converted 8 digits at a time, without a loop. Returns
+// false if `digits` is not such a number.
+bool parse_short_decimal(std::string_view digits, std::uint64_t& magnitude) {
+  if constexpr (std::endian::native != std::endian::little) {
+    return false;
+  }
+  const char* data = digits.data();
+  std::size_t size = digits.size();
+  if (size == 0 || size > 16) {
+    return false;
+  }
+  std::uint64_t low = load_digits(data + size - std::min<std::size_t>(size, 8),
+                                  std::min<std::size_t>(size, 8));
+  if (!is_eight_digits(low)) {
+    return false;
+  }
+  magnitude = parse_eight_digits(low);
+  if (size > 8) {
+    std::uint64_t high = load_digits(data, size - 8);
+    if (!is_eight_digits(high)) {
+      return false;
+    }
+    magnitude += parse_eight_digits(high) * 100000000;
+  }
+  return true;
+}
+
+[[noreturn]] void throw_invalid_integer(std::string_view value) {
+  throw_invalid_argument_exception("Invalid integer value `" +
+                                   std::string(value) + "`");
+}
+
+[[noreturn]] void throw_integer_out_of_range(std::string_view value) {
+  throw_invalid_argument_exception("Integer value `" + std::string(value) +
+                                   "` is out of range");
+}
+
+bool is_digit(char c, int base) {
+  unsigned digit = 0;
+  return std::from_chars(&c, &c + 1, digit, base).ec == std::errc();
+}
+
+// Parse the digits of `value` (without sign and radix prefix) in `base`.
+// Digits can be separated by single `_`, as in `1_000_000`.
+std::uint64_t parse_magnitude(std::string_view value, std::string_view digits,
+                              int base) {
+  if (digits.empty()) {
+    throw_invalid_integer(value);
+  }
+  // Enough for the 64 binary digits of the largest magnitude. Leading zeros
+  // are skipped, so any longer number is out of range.
+  char buffer[64];
+  if (digits.find('_') != std::string_view::npos) {
+    if (digits.front() == '_' || digits.back() == '_' ||
+        digits.find("__") != std::string_view::npos) {
+      throw_invalid_integer(value);
+    }
+    std::size_t size = 0;
+    for (char c: digits) {
+      if (c == '_' || (c == '0' && size == 0)) {
+        continue;
+      }
+      if (size == sizeof(buffer)) {
+        // Still has to be a valid number, to tell which error to raise.
+        if (!std::all_of(digits.begin(), digits.end(), [base](char digit) {
+              return digit == '_' || is_digit(digit, base);
+            })) {
+          throw_invalid_integer(value);
+        }
+        throw_integer_out_of_range(value);
+      }
+      buffer[size++] = c;
+    }
+    digits = size == 0 ? std::string_view("0") : std::string_view(buffer, size);
+  }
+  std::uint64_t magnitude = 0;
+  const char* end = digits.data() + digits.size();
+  auto [ptr, error] = std::from_chars(digits.data(), end, magnitude, base);
+  if (error == std::errc::result_out_of_range) {
+    throw_integer_out_of_range(value);
+  }
+  if (error != std::errc() || ptr != end) {
+    throw_invalid_integer(value);
+  }
+  return magnitude;
+}
+
+// The radix of the prefix `0<prefix>`, or 10 for numbers without a prefix.
+int radix_of_prefix(char prefix) {
+  switch (prefix) {
+    case 'x':
+    case 'X':
+      return 16;
+    case 'o':
+    case 'O':
+      return 8;
+    case 'b':
+    case 'B':
+      return 2;
+    default:
+      return 10;
+  }
+}
+
+// Parse an integer with an optional sign, an optional radix prefix (`0x`,
+// `0o` or `0b`) and optional `_` digit separators, checking that it fits in
+// `T` exactly.
+template<class T>
+T parse_integer(std::string_view value) {
+  std::string_view digits = value;
+  bool negative = false;
+  if (!digits.empty() && (digits.front() == '-' || digits.front() == '+')) {
+    negative = digits.front() == '-';
+    digits.remove_prefix(1);
+  }
+  int base = 10;
+  if (digits.size() > 1 && digits[0] == '0') {
+    base = radix_of_prefix(digits[1]);
+    if (base != 10) {
+      digits.remove_prefix(2);
+    }
+  }
+  std::uint64_t magnitude = 0;
+  if (base != 10 || !parse_short_decimal(digits, magnitude)) {
+    magnitude = parse_magnitude(value, digits, base);
+  }
+
+  using Unsigned = std::make_unsigned_t<T>;
+  auto max_magnitude =
+      static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+  if (negative) {
+    if constexpr (std::is_unsigned_v<T>) {
+      if (magnitude != 0) {
+        throw_integer_out_of_range(value);
+      }
+      return 0;
+    } else {
+      // |min| is one more than max.
+      if (magnitude > max_magnitude + 1) {
+        throw_integer_out_of_range(value);
+      }
+      // Negate in the unsigned type, where the wrap around is well defined.
+      return static_cast<T>(
+          static_cast<Unsigned>(0U - static_cast<Unsigned>(magnitude)));
+    }
+  }
+  if (magnitude > max_magnitude) {
+    throw_integer_out_of_range(value);
+  }
+  return static_cast<T>(magnitude);
+}
+
+[[noreturn]] void throw_invalid_floating(std::string_view value) {
+  throw_invalid_argument_exception("Invalid floating point value `" +
+                                   std::string(value) + "`");
+}
+
+// Parse a floating point number independently of the locale, with an optional
+// sign, in decimal or in hexadecimal with a `0x` prefix (as `0x1.8p3`), or one
+// of `inf`, `infinity` and `nan`. The whole value must be a number.
+template<class T>
+T parse_floating(std::string_view value) {
+  std::string_view number = value;
+  bool negative = false;
+  if (!number.empty() && (number.front() == '-' || number.front() == '+')) {
+    negative = number.front() == '-';
+    number.remove_prefix(1);
+  }
+  std::chars_format format = std::chars_format::general;
+  if (number.size() > 1 && number[0] == '0' &&
+      (number[1] == 'x' || number[1] == 'X')) {
+    format = std::chars_format::hex;
+    number.remove_prefix(2);
+  }
+  // from_chars accepts a minus sign of its own.
+  if (number.empty() || number.front() == '-' || number.front() == '+') {
+    throw_invalid_floating(value);
+  }
+  T result = 0;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  const char* end = number.data() + number.size();
+  auto [ptr, error] = std::from_chars(number.data(), end, result, format);
+  if (error == std::errc::result_out_of_range) {
+    throw_invalid_argument_exception("Floating point value `" +
+                                     std::string(value) + "` is out of range");
+  }
+  if (error != std::errc() || ptr != end) {
+    throw_invalid_floating(value);
+  }
+#else
+  // Without floating point from_chars, a stream in the classic locale is the
+  // only locale-independent conversion.
+  std::istringstream stream{std::string(number)};
+  stream.imbue(std::locale::classic());
+  if (format == std::chars_format::hex) {
+    stream >> std::hexfloat;
+  }
+  stream >> result;
+  if (stream.fail() || stream.peek() != std::char_traits<char>::eof()) {
+    throw_invalid_floating(value);
+  }
+#endif
+  return negative ? -result : result;
+}
+
+} // namespace
+
+template<>
+char from_string(std::string_view value) {
+  return parse_integer<char>(value);
+}
+
 template<>
-char from_string(const std::string& value) {
-  return static_cast<char>(std::stoi(value));
+signed char from_string(std::string_view value) {
+  return parse_integer<signed char>(value);
 }
 
 template<>
-unsigned char from_string(const std::string& value) {
-  return static_cast<unsigned char>(std::stoul(value));
+unsigned char from_string(std::string_view value) {
+  return parse_integer<unsigned char>(value);
 }
 
 template<>
-short int from_string(const std::string& value) {
-  return static_cast<short int>(std::stoi(value));
+short int from_string(std::string_view value) {
+  return parse_integer<short int>(value);
 }
 
 template<>
-unsigned short int from_string(const std::string& value) {
-  return static_cast<unsigned short int>(std::stoul(value));
+unsigned short int from_string(std::string_view value) {
+  return parse_integer<unsigned short int>(value);
 }
 
 template<>
-int from_string(const std::string& value) {
-  return std::stoi(value);
+int from_string(std::string_view value) {
+  return parse_integer<int>(value);
 }
 
 template<>
-unsigned int from_string(const std::string& value) {
-  return static_cast<unsigned int>(std::stoul(value));
+unsigned int from_string(std::string_view value) {
+  return parse_integer<unsigned int>(value);
 }
 
 template<>
-long from_string(const std::string& value) {
-  return std::stol(value);
+long from_string(std::string_view value) {
+  return parse_integer<long>(value);
 }
 
 template<>
-unsigned long from_string(const std::string& value) {
-  return std::stoul(value);
+unsigned long from_string(std::string_view value) {
+  return parse_integer<unsigned long>(value);
 }
 
 template<>
-long long from_string(const std::string& value) {
-  return std::stoll(value);
+long long from_string(std::string_view value) {
+  return parse_integer<long long>(value);
 }
 
 template<>
-unsigned long long from_string(const std::string& value) {
-  return std::stoull(value);
+unsigned long long from_string(std::string_view value) {
+  return parse_integer<unsigned long long>(value);
 }
 
 template<>
-float from_string(const std::string& value) {
-  return std::stof(value);
+float from_string(std::string_view value) {
+  return parse_floating<float>(value);
 }
 
 template<>
-double from_string(const std::string& value) {
-  return std::stod(value);
+double from_string(std::string_view value) {
+  return parse_floating<double>(value);
 }
 
 template<>
-long double from_string(const std::string& value) {
-  return std::stold(value);
+long double from_string(std::string_view value) {
+  return parse_floating<long double>(value);
 }
 
 } // namespace internal
 
-} // namespace mcga::cli
\ No newline at end of file
+} // namespace mcga::cli
@@ -0,0 +1,76 @@
+#include <mcga/cli/option_index.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <functional>
+
+namespace mcga::cli::internal {
+
+OptionIndex::OptionIndex(std::pmr::memory_resource* resource)
+    : entries(resource), slots(resource), keys(resource) {}
+
+void OptionIndex::insert(std::string_view key, std::uint32_t value) {
+  entries.emplace_back(key, value);
+  if (key.size() == 1) {
+    short_slots[static_cast<unsigned char>(key[0])] = value;
+  }
+  built = false;
+}
+
+void OptionIndex::build() {
+  // Keep the load factor at or below 1/2, so probe sequences stay short.
+  std::size_t capacity = std::bit_ceil(std::max<std::size_t>(
+      2 * entries.size(), static_cast<std::size_t>(16)));
+  mask = capacity - 1;
+  slots.assign(capacity, Slot{});
+  keys.clear();
+  for (const auto& entry: entries) {
+    keys += entry.first;
+  }
+
+  std::uint32_t key_offset = 0;
+  for (const auto& [key, value]: entries) {
+    std::size_t hash = hash_key(key);
+    std::size_t pos = hash & mask;
+    while (slots[pos].value != npos) {
+      pos = (pos + 1) & mask;
+    }
+    slots[pos] = Slot{hash, key_offset, static_cast<std::uint32_t>(key.size()),
+                      value};
+    key_offset += static_cast<std::uint32_t>(key.size());
+  }
+  built = true;
+}
+
+bool OptionIndex::is_built() const {
+  return built;
+}
+
+std::uint32_t OptionIndex::find(std::string_view key) const {
+  if (slots.empty()) {
+    return npos;
+  }
+  std::size_t hash = hash_key(key);
+  for (std::size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+    const Slot& slot = slots[pos];
+    if (slot.value == npos) {
+      return npos;
+    }
+    if (slot.hash == hash && slot.key_length == key.size() &&
+        std::memcmp(keys.data() + slot.key_offset, key.data(), key.size()) ==
+            0) {
+      return slot.value;
+    }
+  }
+}
+
+std::size_t OptionIndex::size() const {
+  return entries.size();
+}
+
+std::size_t OptionIndex::hash_key(std::string_view key) {
+  return std::hash<std::string_view>{}(key);
+}
+
+} // namespace mcga::cli::internal
@@ -0,0 +1,18 @@
+#include <mcga/cli/parse_stats.hpp>
+
+namespace mcga::cli {
+
+void ParseStats::clear() {
+  tokens = 0;
+  lookups = 0;
+  lookup_misses = 0;
+  appeared_options = 0;
+  defaults_evaluated = 0;
+  generator_times.clear();
+  reset_time = {};
+  tokenize_time = {};
+  defaults_time = {};
+  terminal_flags_time = {};
+}
+
+} // namespace mcga::cli
@@ -1,36 +1,194 @@
 #include <mcga/cli/parser.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <latch>
+#include <thread>
+#include <utility>
+
+#include <mcga/cli/environment.hpp>
+#include <mcga/cli/thread_pool.hpp>
+#include <mcga/cli/tokenizer.hpp>
 
 namespace mcga::cli {
 
-Parser::Parser(const std::string& help_prefix_)
-    : help_prefix(help_prefix_ + "\n") {}
+namespace {
+
+template<class Handler, class Args>
+void feed_args(internal::Tokenizer<Handler>& tokenizer, const Args& args,
+               internal::ResponseFiles* response_files,
+               ParseStats* stats = nullptr) {
+  if (response_files == nullptr) {
+    for (std::string_view arg: args) {
+      tokenizer.feed(arg);
+    }
+    if (stats != nullptr) {
+      stats->tokens += std::size(args);
+    }
+    return;
+  }
+  auto feed = [&tokenizer, stats](std::string_view arg) {
+    if (stats != nullptr) {
+      ++stats->tokens;
+    }
+    tokenizer.feed(arg);
+  };
+  for (std::string_view arg: args) {
+    response_files->expand(arg, feed);
+  }
+}
+
+internal::ThreadPool& default_generators_pool() {
+  // generators usually block on I/O, and a parse running on the shared pool
+  // (see ParserSchema::parse_batch) must not wait for tasks queued behind it,
+  // so they get a pool of their own.
+  static internal::ThreadPool pool(std::thread::hardware_concurrency());
+  return pool;
+}
+
+} // namespace
+
+auto ParseResult::positional_args() const -> const ArgViewList& {
+  return positional;
+}
+
+void ParseResult::resolve_all() const {
+  for (const auto& option: options) {
+    option->resolve_default();
+  }
+}
+
+auto ParseResult::instance_of(const internal::CommandLineOption* prototype)
+    const -> const internal::CommandLineOption& {
+  if (prototype == nullptr || prototype->index >= options.size() ||
+      options[prototype->index]->prototype != prototype) {
+    internal::throw_logic_error(
+        "ParseResult read an option that is not part of the schema it was "
+        "parsed with.");
+  }
+  return *options[prototype->index];
+}
+
+ParserSchema::ParserSchema(std::vector<CommandLineOptionPtr> options_,
+                           internal::OptionIndex index_,
+                           internal::OptionIndex env_vars_index_,
+                           internal::ConfigFiles config_files_,
+                           std::string help_,
+                           internal::ParseSettings settings_)
+    : options(std::move(options_)),
+      index(std::move(index_)),
+      env_vars_index(std::move(env_vars_index_)),
+      config_files(std::move(config_files_)),
+      help(std::move(help_)),
+      settings(std::move(settings_)) {}
+
+ParseResult ParserSchema::parse(const ArgList& args,
+                               std::pmr::memory_resource* resource) const {
+  return parse_args(args, resource);
+}
+
+ParseResult
+    ParserSchema::parse(std::initializer_list<std::string_view> args,
+                        std::pmr::memory_resource* resource) const {
+  return parse_args(args, resource);
+}
+
+ParseResult ParserSchema::parse(std::span<const std::string_view> args,
+                               std::pmr::memory_resource* resource) const {
+  return parse_args(args, resource);
+}
+
+ParseResult ParserSchema::parse(std::span<const char* const> args,
+                               std::pmr::memory_resource* resource) const {
+  return parse_args(args, resource);
+}
+
+auto ParserSchema::parse_batch(std::span<const ArgList> batch) const
+    -> std::vector<ParseOutcome> {
+  std::vector<ParseOutcome> outcomes(batch.size());
+  internal::ThreadPool& pool = internal::ThreadPool::shared();
+  // chunks are small enough for stealing to balance uneven command lines,
+  // and large enough to amortize scheduling.
+  std::size_t chunk_size =
+      std::clamp<std::size_t>(batch.size() / (8 * pool.size()), 1, 256);
+  std::size_t num_chunks = (batch.size() + chunk_size - 1) / chunk_size;
+  std::latch done(static_cast<std::ptrdiff_t>(num_chunks));
+  for (std::size_t begin = 0; begin < batch.size(); begin += chunk_size) {
+    std::size_t end = std::min(begin + chunk_size, batch.size());
+    pool.submit([this, batch, &outcomes, &done, begin, end] {
+      for (std::size_t i = begin; i < end; ++i) {
+#ifdef __EXCEPTIONS
+        try {
+          outcomes[i].result.emplace(
+              parse(batch[i], std::pmr::new_delete_resource()));
+        } catch (...) {
+          outcomes[i].error = std::current_exception();
+        }
+#else
+        outcomes[i].result.emplace(
+            parse(batch[i], std::pmr::new_delete_resource()));
+#endif
+      }
+      done.count_down();
+    });
+  }
+  done.wait();
+  return outcomes;
+}
+
+const std::string& ParserSchema::render_help() const {
+  return help;
+}
+
+template<class Args>
+ParseResult
+    ParserSchema::parse_args(const Args& args,
+                             std::pmr::memory_resource* resource) const {
+  ParseResult result;
+  result.options.reserve(options.size());
+  for (const CommandLineOptionPtr& option: options) {
+    result.options.push_back(option->create_instance(resource));
+    result.options.back()->prototype = option.get();
+  }
+  result.positional = Parser::apply_args(
+      index, result.options, args,
+      settings.expand_response_files ? &result.response_files : nullptr,
+      nullptr);
+  Parser::apply_defaults(result.options, &env_vars_index, &config_files,
+                         settings);
+  return result;
+}
+
+Parser::Parser(const std::string& help_prefix_,
+               std::pmr::memory_resource* resource_)
+    : resource(resource_),
+      specs_by_cli_string(resource),
+      specs_by_env_var(resource),
+      help(help_prefix_, resource) {}
+
+Parser::~Parser() = default;
 
 Argument Parser::add_argument(const ArgumentSpec& spec) {
-  check_name_availability(spec.name, spec.short_name);
-  auto argument = std::make_shared<internal::ArgumentImpl>(spec);
-  add_spec(argument, spec.name, spec.short_name);
-  std::string extra;
-  if (spec.default_value.has_value() && spec.implicit_value.has_value()) {
-    extra = "Default: '" + spec.default_value.value().get_description() +
-            "', Implicit: '" + spec.implicit_value.value().get_description() +
-            "'";
-  } else if (spec.default_value.has_value()) {
-    extra = "Default: '" + spec.default_value.value().get_description() + "'";
-  } else if (spec.implicit_value.has_value()) {
-    extra = "Implicit: '" + spec.implicit_value.value().get_description() + "'";
-  }
-  add_help(spec.help_group, spec.name, spec.short_name, spec.description,
-           extra);
+  check_name_availability(spec.name, spec.short_name, spec.env_var);
+  auto argument =
+      internal::allocate_shared_from<internal::ArgumentImpl>(resource, spec,
+                                                             resource);
+  add_spec(argument, spec.name, spec.short_name, spec.env_var);
+  help.add(internal::HelpEntry::from_spec(argument->get_spec()));
   return Argument(std::move(argument));
 }
 
 Flag Parser::add_flag(const FlagSpec& spec) {
-  check_name_availability(spec.name, spec.short_name);
-  auto flag = std::make_shared<internal::FlagImpl>(spec);
-  add_spec(flag, spec.name, spec.short_name);
-  add_help(spec.help_group, spec.name, spec.short_name, spec.description, "");
+  check_name_availability(spec.name, spec.short_name, spec.env_var);
+  auto flag =
+      internal::allocate_shared_from<internal::FlagImpl>(resource, spec,
+                                                         resource);
+  add_spec(flag, spec.name, spec.short_name, spec.env_var);
+  // Flags are only ever described by their name, without their values.
+  internal::HelpEntry entry = internal::HelpEntry::from_spec(flag->get_spec());
+  entry.default_description = nullptr;
+  entry.implicit_description = nullptr;
+  help.add(std::move(entry));
   return Flag(std::move(flag));
 }
 
@@ -50,165 +208,805 @@ void Parser::add_help_flag() {
   add_terminal_flag(FlagSpec("help").set_short_name("h").set_description(
                         "Display this help menu."),
                     [this]() {
-                      std::cout << render_help();
+                      std::cout << render_help(
+                          internal::HelpTable::terminal_width());
                     });
 }
 
-auto Parser::parse(const ArgList& args) -> ArgList {
-  for (const CommandLineOptionPtr& spec: specs) {
-    spec->reset();
+template<class Positional>
+class Parser::TokenHandler {
+public:
+  TokenHandler(const internal::OptionIndex& index_,
+               const std::vector<CommandLineOptionPtr>& options_,
+               Positional& positional_args_, ParseStats* stats_)
+      : index(index_),
+        options(options_),
+        positional_args(positional_args_),
+        stats(stats_) {}
+
+  void on_positional(std::string_view arg) {
+    positional_args.push_back(arg);
+  }
+
+  void on_value(std::string_view name, std::string_view value) {
+    apply_value(options, count_lookup(index.find(name), stats), value);
+  }
+
+  void on_implicit(std::string_view name) {
+    apply_implicit(options, count_lookup(index.find(name), stats));
+  }
+
+  void on_short_value(char name, std::string_view value) {
+    apply_value(options, count_lookup(index.find_short(name), stats), value);
+  }
+
+  void on_short_implicit(char name) {
+    apply_implicit(options, count_lookup(index.find_short(name), stats));
+  }
+
+  // Not counted as a lookup: `on_short_value` or `on_short_implicit` looks
+  // the same name up again.
+  bool consumes_short_value(char name) {
+    return should_apply_value(options, index.find_short(name));
+  }
+
+private:
+  const internal::OptionIndex& index;
+  const std::vector<CommandLineOptionPtr>& options;
+  Positional& positional_args;
+  ParseStats* stats;
+};
+
+class Parser::DeltaHandler {
+public:
+  DeltaHandler(const Parser& parser_, ArgViewList& positional_args_,
+               std::vector<DeltaEvent>& events_)
+      : parser(parser_), positional_args(positional_args_), events(events_) {}
+
+  void on_positional(std::string_view arg) {
+    positional_args.push_back(arg);
+  }
+
+  void on_value(std::string_view name, std::string_view value) {
+    record(parser.specs_by_cli_string.find(name), false, value);
+  }
+
+  void on_implicit(std::string_view name) {
+    record(parser.specs_by_cli_string.find(name), true, {});
+  }
+
+  void on_short_value(char name, std::string_view value) {
+    record(parser.specs_by_cli_string.find_short(name), false, value);
+  }
+
+  void on_short_implicit(char name) {
+    record(parser.specs_by_cli_string.find_short(name), true, {});
+  }
+
+  bool consumes_short_value(char name) {
+    return should_apply_value(parser.specs,
+                              parser.specs_by_cli_string.find_short(name));
+  }
+
+private:
+  void record(std::uint32_t spec_index, bool implicit, std::string_view value) {
+    if (spec_index != internal::OptionIndex::npos) {
+      events.push_back({spec_index, implicit, value, ValueSource::arguments});
+    }
+  }
+
+  const Parser& parser;
+  ArgViewList& positional_args;
+  std::vector<DeltaEvent>& events;
+};
+
+class Parser::StreamHandler {
+public:
+  StreamHandler(const Parser& parser_, ParseStats* stats_)
+      : parser(parser_), stats(stats_) {}
+
+  void on_positional(std::string_view arg) {
+    positional_args.emplace_back(arg);
+  }
+
+  void on_value(std::string_view name, std::string_view value) {
+    resolve(parser.specs_by_cli_string.find(name), value);
+  }
+
+  void on_implicit(std::string_view name) {
+    resolve_implicit(parser.specs_by_cli_string.find(name));
+  }
+
+  void on_short_value(char name, std::string_view value) {
+    resolve(parser.specs_by_cli_string.find_short(name), value);
+  }
+
+  void on_short_implicit(char name) {
+    resolve_implicit(parser.specs_by_cli_string.find_short(name));
+  }
+
+  // Not counted as a lookup, as for TokenHandler.
+  bool consumes_short_value(char name) {
+    return should_apply_value(parser.specs,
+                              parser.specs_by_cli_string.find_short(name));
   }
 
   ArgList positional_args;
-  std::string last_short_name;
-  bool only_positional = false;
-  for (const std::string& arg: args) {
-    // on encountering the "--" argument, all arguments from that point
-    // on are considered positional.
-    if (arg == "--") {
-      only_positional = true;
-      continue;
+
+private:
+  void resolve(std::uint32_t spec_index, std::string_view value) {
+    apply_value(parser.specs, count_lookup(spec_index, stats), value);
+    parser.notify_value(spec_index);
+  }
+
+  void resolve_implicit(std::uint32_t spec_index) {
+    apply_implicit(parser.specs, count_lookup(spec_index, stats));
+    parser.notify_value(spec_index);
+  }
+
+  const Parser& parser;
+  ParseStats* stats;
+};
+
+// The handler holds the positional arguments received so far, and the
+// tokenizer the pending short name.
+struct Parser::StreamState {
+  StreamState(const Parser& parser, ParseStats* stats)
+      : handler(parser, stats) {}
+
+  MCGA_DISALLOW_COPY_AND_MOVE(StreamState);
+
+  ~StreamState() = default;
+
+  StreamHandler handler;
+  internal::Tokenizer<StreamHandler> tokenizer{handler};
+};
+
+template<class Args, class Positional>
+Positional Parser::apply_args(const internal::OptionIndex& index,
+                              const std::vector<CommandLineOptionPtr>& options,
+                              const Args& args,
+                              internal::ResponseFiles* response_files,
+                              ParseStats* stats, Positional positional_args) {
+  TokenHandler<Positional> handler(index, options, positional_args, stats);
+  internal::Tokenizer<TokenHandler<Positional>> tokenizer(handler);
+  feed_args(tokenizer, args, response_files, stats);
+  tokenizer.finish();
+  return positional_args;
+}
+
+template<class Args, class Positional>
+Positional Parser::parse_args(const Args& args, Positional positional_args) {
+  start_parse();
+  auto start = phase_start();
+  Positional parsed_positional_args = apply_args(
+      specs_by_cli_string, specs, args,
+      settings.expand_response_files ? &response_files : nullptr,
+      current_stats(), std::move(positional_args));
+  add_phase_time(stats.tokenize_time, start);
+  finish_parse();
+  return parsed_positional_args;
+}
+
+void Parser::enable_lazy_defaults() {
+  settings.lazy_defaults = true;
+}
+
+void Parser::keep_defaults_across_parses() {
+  settings.keep_defaults = true;
+}
+
+void Parser::resolve_all() const {
+  std::vector<std::pair<std::uint32_t, std::exception_ptr>> errors;
+  if (settings.concurrent_defaults) {
+    errors = generate_independent_defaults(specs, settings.executor);
+  }
+  auto error = errors.begin();
+  for (std::uint32_t i = 0; i < specs.size(); ++i) {
+    if (error != errors.end() && error->first == i) {
+      std::rethrow_exception(error->second);
     }
+    specs[i]->resolve_default();
+  }
+}
 
-    // all arguments after "--" are considered positional.
-    if (only_positional) {
-      positional_args.push_back(arg);
-      continue;
+void Parser::enable_concurrent_defaults(Executor executor) {
+  settings.concurrent_defaults = true;
+  settings.executor = std::move(executor);
+}
+
+void Parser::load_config_file(const std::string& path) {
+  build_indices();
+  config_files.load(path, specs_by_cli_string);
+  delta_state.valid = false;
+}
+
+void Parser::enable_response_files() {
+  settings.expand_response_files = true;
+  delta_state.valid = false;
+}
+
+auto Parser::parse(const ArgList& args) -> ArgList {
+  return to_arg_list(parse_args(args));
+}
+
+void Parser::begin() {
+  start_parse();
+  stream = std::make_unique<StreamState>(*this, current_stats());
+}
+
+void Parser::feed(std::string_view arg) {
+  if (stream == nullptr) {
+    internal::throw_logic_error(
+        "Parser::feed called without a streaming parse, see Parser::begin.");
+  }
+  auto start = phase_start();
+  ParseStats* parse_stats = current_stats();
+  auto feed_arg = [this, parse_stats](std::string_view expanded_arg) {
+    if (parse_stats != nullptr) {
+      ++parse_stats->tokens;
     }
+    stream->tokenizer.feed(expanded_arg);
+  };
+  if (settings.expand_response_files) {
+    response_files.expand(arg, feed_arg);
+  } else {
+    feed_arg(arg);
+  }
+  add_phase_time(stats.tokenize_time, start);
+}
 
-    // an argument that does not start with '-' (or is equal to "-") is
-    // not considered special, and therefore will be treated like either
-    // a positional argument or a value filler for the last unfulfilled
-    // short name argument given in the format "-XYZ".
-    if (arg.substr(0, 1) != "-" || arg == "-") {
-      if (should_apply_value(last_short_name)) {
-        // `last_short_name` is an unfulfilled argument given by short
-        // name in the format "-XYZ v" as "Z".
-        apply_value(last_short_name, arg);
-        last_short_name = "";
-      } else {
-        // no unfulfilled argument given by short name, considering
-        // a positional argument.
-        positional_args.push_back(arg);
+auto Parser::finish() -> ArgList {
+  if (stream == nullptr) {
+    internal::throw_logic_error(
+        "Parser::finish called without a streaming parse, see Parser::begin.");
+  }
+  std::unique_ptr<StreamState> state = std::move(stream);
+  auto start = phase_start();
+  state->tokenizer.finish();
+  add_phase_time(stats.tokenize_time, start);
+  std::vector<std::uint32_t> pending_callbacks;
+  for (std::uint32_t i = 0; i < value_callbacks.size(); ++i) {
+    if (value_callbacks[i] && !specs[i]->appeared()) {
+      pending_callbacks.push_back(i);
+    }
+  }
+  finish_parse();
+  for (std::uint32_t spec_index: pending_callbacks) {
+    notify_value(spec_index);
+  }
+  return std::move(state->handler.positional_args);
+}
+
+auto Parser::reparse_delta(const ArgList& args) -> ArgList {
+  stream.reset();
+  stats.clear();
+  build_indices();
+
+  // the events keep views into the arguments and the response files, so they
+  // need to be owned until the next call.
+  ArgList new_args = args;
+  internal::ResponseFiles new_response_files;
+  ArgViewList positional_args;
+  std::vector<DeltaEvent> events;
+  DeltaHandler handler(*this, positional_args, events);
+  internal::Tokenizer<DeltaHandler> tokenizer(handler);
+  feed_args(tokenizer, new_args,
+            settings.expand_response_files ? &new_response_files : nullptr);
+  tokenizer.finish();
+
+  // values from the environment are events too, so that an argument is
+  // updated when its variable changes. They are copied, since the environment
+  // can change before the next call.
+  std::vector<internal::EnvironmentValue> env_values;
+  if (specs_by_env_var.size() != 0) {
+    env_values = internal::read_environment(specs_by_env_var);
+  }
+  std::vector<std::string> new_env_values;
+  new_env_values.reserve(env_values.size());
+  for (const internal::EnvironmentValue& env_value: env_values) {
+    events.push_back({env_value.option_index, false,
+                      new_env_values.emplace_back(env_value.value),
+                      ValueSource::environment});
+  }
+  // the parser keeps the config files mapped, and loading a file starts a
+  // full parse, so config entries can be kept as views.
+  for (const internal::ConfigEntry& entry: config_files.get_entries()) {
+    events.push_back({entry.option_index, entry.implicit, entry.value,
+                      ValueSource::config_files});
+  }
+
+  // the state of an argument only depends on the sequence of its own
+  // occurrences, so events are grouped by argument, keeping their order.
+  std::stable_sort(events.begin(), events.end(),
+                   [](const DeltaEvent& lhs, const DeltaEvent& rhs) {
+                     return lhs.spec_index < rhs.spec_index;
+                   });
+
+  bool full_parse = !delta_state.valid;
+  // if applying any value throws, the next call must start from scratch.
+  delta_state.valid = false;
+#ifdef __EXCEPTIONS
+  try {
+    replay_delta(events, full_parse);
+  } catch (...) {
+    // the events are replayed grouped by argument, so the error is not
+    // necessarily the one of the first invalid argument. A full parse reports
+    // the same error as `parse` would.
+    parse(args);
+    throw;
+  }
+#else
+  replay_delta(events, full_parse);
+#endif
+
+  delta_state.args = std::move(new_args);
+  delta_state.events = std::move(events);
+  delta_state.env_values = std::move(new_env_values);
+  delta_state.response_files = std::move(new_response_files);
+  delta_state.valid = true;
+  return to_arg_list(positional_args);
+}
+
+void Parser::replay_delta(const std::vector<DeltaEvent>& events,
+                          bool full_parse) {
+  if (full_parse) {
+    start_parse();
+    for (auto it = events.cbegin(); it != events.cend();) {
+      auto group_end = std::find_if(it, events.cend(),
+                                    [&](const DeltaEvent& event) {
+                                      return event.spec_index != it->spec_index;
+                                    });
+      replay_option(it, group_end);
+      it = group_end;
+    }
+    apply_defaults(specs, nullptr, nullptr, settings);
+    run_terminal_flags();
+  } else {
+    const auto& old_events = delta_state.events;
+    auto old_it = old_events.begin();
+    auto new_it = events.begin();
+    while (old_it != old_events.end() || new_it != events.end()) {
+      std::uint32_t spec_index = std::min(
+          old_it != old_events.end() ? old_it->spec_index : UINT32_MAX,
+          new_it != events.end() ? new_it->spec_index : UINT32_MAX);
+      auto old_end = std::find_if(old_it, old_events.end(),
+                                  [&](const DeltaEvent& event) {
+                                    return event.spec_index != spec_index;
+                                  });
+      auto new_end = std::find_if(new_it, events.end(),
+                                  [&](const DeltaEvent& event) {
+                                    return event.spec_index != spec_index;
+                                  });
+      if (!std::equal(old_it, old_end, new_it, new_end)) {
+        const CommandLineOptionPtr& spec = specs[spec_index];
+        spec->reset();
+        if (new_it == new_end) {
+          spec->set_default_guarded(settings.lazy_defaults);
+        } else {
+          replay_option(new_it, new_end);
+        }
       }
-      continue;
+      old_it = old_end;
+      new_it = new_end;
     }
+    run_terminal_flags();
+  }
+}
+
+auto Parser::parse(std::initializer_list<std::string_view> args) -> ArgList {
+  return to_arg_list(parse_args(args));
+}
 
-    // if we reached this point without hitting a `continue`, now the
-    // current argument is definitely a special one.
+auto Parser::parse(int argc, char** argv) -> ArgList {
+  return to_arg_list(parse(
+      std::span<const char* const>(argv, static_cast<std::size_t>(argc))));
+}
+
+auto Parser::parse(std::span<const std::string_view> args) -> ArgViewList {
+  return parse_args(args);
+}
+
+auto Parser::parse(std::span<const char* const> args) -> ArgViewList {
+  return parse_args(args);
+}
+
+auto Parser::parse(std::span<const std::string_view> args,
+                   std::pmr::memory_resource* positional_resource)
+    -> PmrArgViewList {
+  return parse_args(args, PmrArgViewList(positional_resource));
+}
 
-    // if we had an unfulfilled argument given by short name, we will
-    // give it its implicit value since it won't be fulfilled by this
-    // argument.
-    if (!last_short_name.empty()) {
-      apply_implicit(last_short_name);
-      last_short_name = "";
+void Parser::build_indices() {
+  if (!specs_by_cli_string.is_built()) {
+    specs_by_cli_string.build();
+  }
+  if (!specs_by_env_var.is_built()) {
+    specs_by_env_var.build();
+  }
+}
+
+void Parser::start_parse() {
+  auto start = phase_start();
+  stats.clear();
+  stream.reset();
+  delta_state.valid = false;
+  response_files.clear();
+  build_indices();
+  for (const CommandLineOptionPtr& spec: specs) {
+    if (!settings.keep_defaults ||
+        spec->default_state ==
+            internal::CommandLineOption::DefaultState::none) {
+      spec->reset();
     }
+  }
+  add_phase_time(stats.reset_time, start);
+}
 
-    auto equal_pos = arg.find('=');
+void Parser::finish_parse() {
+  auto start = phase_start();
+  apply_defaults(specs, &specs_by_env_var, &config_files, settings,
+                 current_stats());
+  add_phase_time(stats.defaults_time, start);
+  if (collect_stats) {
+    stats.appeared_options = static_cast<std::size_t>(
+        std::count_if(specs.begin(), specs.end(),
+                      [](const CommandLineOptionPtr& option) {
+                        return option->appeared();
+                      }));
+  }
+  start = phase_start();
+  run_terminal_flags();
+  add_phase_time(stats.terminal_flags_time, start);
+}
 
-    // 1. for "--X", give argument "X" its implicit value
-    if (arg.substr(0, 2) == "--" && equal_pos == std::string::npos) {
-      apply_implicit(arg.substr(2));
+void Parser::apply_defaults(const std::vector<CommandLineOptionPtr>& options,
+                            const internal::OptionIndex* env_vars_index,
+                            const internal::ConfigFiles* config_files,
+                            const internal::ParseSettings& settings,
+                            ParseStats* stats) {
+  if (env_vars_index != nullptr && env_vars_index->size() != 0) {
+    for (const internal::EnvironmentValue& env_value:
+         internal::read_environment(*env_vars_index)) {
+      const CommandLineOptionPtr& option = options[env_value.option_index];
+      // as with getenv, the first definition of a variable wins.
+      if (!option->appeared()) {
+        option->set_value_guarded(env_value.value);
+      }
+    }
+  }
+  if (config_files != nullptr) {
+    const auto& entries = config_files->get_entries();
+    for (auto it = entries.begin(); it != entries.end();) {
+      auto group_end = std::find_if(it, entries.end(),
+                                    [&](const internal::ConfigEntry& entry) {
+                                      return entry.option_index !=
+                                             it->option_index;
+                                    });
+      // all the entries of an option apply, so that list arguments collect
+      // every value, unless the option was already set.
+      if (!options[it->option_index]->appeared()) {
+        for (; it != group_end; ++it) {
+          if (it->implicit) {
+            apply_implicit(options, it->option_index);
+          } else {
+            apply_value(options, it->option_index, it->value);
+          }
+        }
+      }
+      it = group_end;
     }
+  }
+  std::vector<std::pair<std::uint32_t, std::exception_ptr>> errors;
+  if (settings.concurrent_defaults && !settings.lazy_defaults) {
+    errors = generate_independent_defaults(options, settings.executor, stats);
+  }
+  generate_defaults(options, settings.lazy_defaults, errors, stats);
+}
 
-    // 2. for "--X=v", give argument "X" value "v"
-    if (arg.substr(0, 2) == "--" && equal_pos != std::string::npos) {
-      apply_value(arg.substr(2, equal_pos - 2), arg.substr(equal_pos + 1));
+auto Parser::generate_independent_defaults(
+    const std::vector<CommandLineOptionPtr>& options, const Executor& executor,
+    ParseStats* stats)
+    -> std::vector<std::pair<std::uint32_t, std::exception_ptr>> {
+  using DefaultState = internal::CommandLineOption::DefaultState;
+  // the generators allocate the values of their options from the resource
+  // that all of them share, which must then be safe to use concurrently.
+  if (options.empty() ||
+      !internal::is_synchronized(options.front()->resource)) {
+    return {};
+  }
+  std::vector<std::uint32_t> pending;
+  for (std::uint32_t i = 0; i < options.size(); ++i) {
+    const CommandLineOptionPtr& option = options[i];
+    if (!option->independent_default_value) {
+      continue;
     }
+    if (option->default_state == DefaultState::deferred ||
+        (option->default_state == DefaultState::none && !option->appeared() &&
+         option->has_default_value)) {
+      pending.push_back(i);
+    }
+  }
+  if (pending.size() < 2) {
+    return {};
+  }
 
-    // 3. for "-XYZ", give arguments "X" and "Y" their implicit values,
-    // and remember "Z" as the last short name, as a construct of the
-    // form "-XYZ v" is allowed, equivalent with "--X --Y --Z=v".
-    if (arg.substr(0, 2) != "--" && equal_pos == std::string::npos) {
-      for (size_t j = 1; j + 1 < arg.length(); ++j) {
-        apply_implicit(arg.substr(j, 1));
+  // every task only touches its own option, so tasks need no synchronization
+  // other than waiting for all of them.
+  std::vector<std::exception_ptr> task_errors(pending.size());
+  std::vector<std::chrono::nanoseconds> task_times(
+      stats != nullptr ? pending.size() : 0);
+  std::latch done(static_cast<std::ptrdiff_t>(pending.size()));
+  auto run_task = [&options, &pending, &task_errors, &task_times,
+                   &done](std::size_t i) {
+    const CommandLineOptionPtr& option = options[pending[i]];
+    auto start = task_times.empty() ? std::chrono::steady_clock::time_point{}
+                                    : std::chrono::steady_clock::now();
+#ifdef __EXCEPTIONS
+    try {
+      if (option->default_state == DefaultState::deferred) {
+        option->resolve_default();
+      } else {
+        option->set_default_guarded(false);
       }
-      last_short_name = arg.substr(arg.length() - 1, 1);
+    } catch (...) {
+      task_errors[i] = std::current_exception();
     }
-
-    // 4. for "-XYZ=v", give arguments "X" and "Y" their implicit values
-    // and argument "Z" value "v".
-    if (arg.substr(0, 2) != "--" && equal_pos != std::string::npos) {
-      for (size_t j = 1; j + 1 < equal_pos; ++j) {
-        apply_implicit(arg.substr(j, 1));
+#else
+    if (option->default_state == DefaultState::deferred) {
+      option->resolve_default();
+    } else {
+      option->set_default_guarded(false);
+    }
+#endif
+    if (!task_times.empty()) {
+      task_times[i] = std::chrono::steady_clock::now() - start;
+    }
+    done.count_down();
+  };
+  auto submit = [&executor](std::function<void()> task) {
+    if (executor) {
+      executor(std::move(task));
+    } else {
+      default_generators_pool().submit(std::move(task));
+    }
+  };
+#ifdef __EXCEPTIONS
+  std::exception_ptr submit_error;
+#endif
+  for (std::size_t i = 0; i < pending.size(); ++i) {
+    std::function<void()> task = [&run_task, i] {
+      run_task(i);
+    };
+#ifdef __EXCEPTIONS
+    try {
+      submit(std::move(task));
+    } catch (...) {
+      // the tasks submitted so far use the state of this call, so the error
+      // is only raised once they are done. The task that failed to be
+      // submitted, and the following ones, run here instead.
+      submit_error = std::current_exception();
+      for (std::size_t j = i; j < pending.size(); ++j) {
+        run_task(j);
       }
-      apply_value(arg.substr(equal_pos - 1, 1), arg.substr(equal_pos + 1));
+      break;
     }
+#else
+    submit(std::move(task));
+#endif
   }
-  if (!last_short_name.empty()) {
-    apply_implicit(last_short_name);
+  done.wait();
+#ifdef __EXCEPTIONS
+  if (submit_error != nullptr) {
+    std::rethrow_exception(submit_error);
   }
+#endif
 
-  for (const CommandLineOptionPtr& spec: specs) {
-    if (!spec->appeared()) {
-      spec->set_default_guarded();
+  std::vector<std::pair<std::uint32_t, std::exception_ptr>> errors;
+  for (std::size_t i = 0; i < pending.size(); ++i) {
+    if (task_errors[i] != nullptr) {
+      errors.emplace_back(pending[i], task_errors[i]);
+    } else if (stats != nullptr) {
+      ++stats->defaults_evaluated;
+      stats->generator_times.push_back(
+          {options[pending[i]]->get_name(), task_times[i]});
     }
   }
+  return errors;
+}
 
+void Parser::generate_defaults(
+    const std::vector<CommandLineOptionPtr>& options, bool lazy,
+    const std::vector<std::pair<std::uint32_t, std::exception_ptr>>& errors,
+    ParseStats* stats) {
+  auto error = errors.begin();
+  for (std::uint32_t i = 0; i < options.size(); ++i) {
+    if (error != errors.end() && error->first == i) {
+      std::rethrow_exception(error->second);
+    }
+    if (options[i]->appeared()) {
+      continue;
+    }
+    if (stats == nullptr) {
+      options[i]->set_default_guarded(lazy);
+    } else {
+      set_default_counted(*options[i], lazy, *stats);
+    }
+  }
+}
+
+void Parser::set_default_counted(internal::CommandLineOption& option,
+                                 bool lazy, ParseStats& stats) {
+  using DefaultState = internal::CommandLineOption::DefaultState;
+  bool generates = !lazy && option.default_state == DefaultState::none;
+  auto start = generates ? std::chrono::steady_clock::now()
+                         : std::chrono::steady_clock::time_point{};
+  option.set_default_guarded(lazy);
+  if (generates) {
+    ++stats.defaults_evaluated;
+    stats.generator_times.push_back(
+        {option.get_name(), std::chrono::steady_clock::now() - start});
+  }
+}
+
+std::uint32_t Parser::count_lookup(std::uint32_t spec_index,
+                                   ParseStats* stats) {
+  if (stats != nullptr) {
+    ++stats->lookups;
+    if (spec_index == internal::OptionIndex::npos) {
+      ++stats->lookup_misses;
+    }
+  }
+  return spec_index;
+}
+
+ParseStats* Parser::current_stats() {
+  return collect_stats ? &stats : nullptr;
+}
+
+void Parser::add_phase_time(std::chrono::nanoseconds& phase_time,
+                            std::chrono::steady_clock::time_point start) const {
+  if (collect_stats) {
+    phase_time += std::chrono::steady_clock::now() - start;
+  }
+}
+
+auto Parser::phase_start() const -> std::chrono::steady_clock::time_point {
+  return collect_stats ? std::chrono::steady_clock::now()
+                       : std::chrono::steady_clock::time_point{};
+}
+
+void Parser::enable_parse_stats(bool enabled) {
+  collect_stats = enabled;
+  stats.clear();
+}
+
+const ParseStats& Parser::last_parse_stats() const {
+  return stats;
+}
+
+void Parser::run_terminal_flags() {
   for (const auto& flag: terminal_flags) {
     if (flag.first->get_value()) {
       flag.second();
       exit(0);
     }
   }
+}
 
-  return positional_args;
+void Parser::add_value_callback(const internal::CommandLineOption* option,
+                                std::function<void()> callback) {
+  if (option == nullptr || option->index >= specs.size() ||
+      specs[option->index].get() != option) {
+    internal::throw_logic_error(
+        "Parser::on_value called with an option of another parser.");
+  }
+  std::uint32_t spec_index = option->index;
+  if (value_callbacks.size() <= spec_index) {
+    value_callbacks.resize(spec_index + 1);
+  }
+  value_callbacks[spec_index] = std::move(callback);
 }
 
-auto Parser::parse(int argc, char** argv) -> ArgList {
-  ArgList args;
-  args.reserve(static_cast<std::size_t>(argc));
-  for (int i = 0; i < argc; ++i) {
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-    args.emplace_back(argv[i]);
+void Parser::notify_value(std::uint32_t spec_index) const {
+  if (spec_index < value_callbacks.size() && value_callbacks[spec_index]) {
+    value_callbacks[spec_index]();
   }
-  return parse(args);
 }
 
-std::string Parser::render_help() const {
-  std::string help = help_prefix + "\n";
-  for (const HelpGroup& group: help_sections) {
-    help += "\n" + group.content;
+void Parser::replay(const DeltaEvent& event) {
+  if (event.implicit) {
+    apply_implicit(specs, event.spec_index);
+  } else {
+    apply_value(specs, event.spec_index, event.value);
   }
-  return help;
+}
+
+void Parser::replay_option(std::vector<DeltaEvent>::const_iterator begin,
+                           std::vector<DeltaEvent>::const_iterator end) {
+  auto highest_priority = std::min_element(
+      begin, end, [](const DeltaEvent& lhs, const DeltaEvent& rhs) {
+        return lhs.source < rhs.source;
+      });
+  ValueSource source = highest_priority->source;
+  for (auto it = begin; it != end; ++it) {
+    if (it->source == source) {
+      replay(*it);
+      // as with getenv, the first definition of a variable wins.
+      if (source == ValueSource::environment) {
+        return;
+      }
+    }
+  }
+}
+
+auto Parser::to_arg_list(const ArgViewList& args) -> ArgList {
+  return ArgList(args.begin(), args.end());
+}
+
+std::shared_ptr<const ParserSchema> Parser::freeze() {
+  build_indices();
+  return std::shared_ptr<const ParserSchema>(
+      new ParserSchema(specs, specs_by_cli_string, specs_by_env_var,
+                       config_files, render_help(), settings));
+}
+
+auto Parser::parse_batch(std::span<const ArgList> batch)
+    -> std::vector<ParseOutcome> {
+  return freeze()->parse_batch(batch);
+}
+
+const std::string& Parser::render_help() const {
+  return help.render();
+}
+
+const std::string& Parser::render_help(std::size_t width) const {
+  return help.render(width);
 }
 
 void Parser::add_spec(const CommandLineOptionPtr& spec, const std::string& name,
-                      const std::string& short_name) {
+                      const std::string& short_name,
+                      const std::string& env_var) {
+  auto spec_index = static_cast<std::uint32_t>(specs.size());
+  delta_state.valid = false;
+  spec->index = spec_index;
   specs.push_back(spec);
   reserved_names.insert(name);
-  specs_by_cli_string[name] = spec;
+  specs_by_cli_string.insert(name, spec_index);
   if (!short_name.empty()) {
     reserved_names.insert(short_name);
-    specs_by_cli_string[short_name] = spec;
+    specs_by_cli_string.insert(short_name, spec_index);
+  }
+  if (!env_var.empty()) {
+    reserved_env_vars.insert(env_var);
+    specs_by_env_var.insert(env_var, spec_index);
   }
 }
 
-void Parser::apply_value(const std::string& cliString,
-                         const std::string& value) {
-  auto it = specs_by_cli_string.find(cliString);
-  if (it != specs_by_cli_string.end()) {
-    it->second->set_value_guarded(value);
+void Parser::apply_value(const std::vector<CommandLineOptionPtr>& options,
+                         std::uint32_t spec_index, std::string_view value) {
+  if (spec_index != internal::OptionIndex::npos) {
+    options[spec_index]->set_value_guarded(value);
   }
 }
 
-void Parser::apply_implicit(const std::string& cliString) {
-  auto it = specs_by_cli_string.find(cliString);
-  if (it != specs_by_cli_string.end()) {
-    it->second->set_implicit_guarded();
+void Parser::apply_implicit(const std::vector<CommandLineOptionPtr>& options,
+                            std::uint32_t spec_index) {
+  if (spec_index != internal::OptionIndex::npos) {
+    options[spec_index]->set_implicit_guarded();
   }
 }
 
 [[nodiscard]] bool
-    Parser::should_apply_value(const std::string& cliString) const {
-  auto it = specs_by_cli_string.find(cliString);
-  return it != specs_by_cli_string.end() &&
-         it->second->consumes_next_positional_arg();
+    Parser::should_apply_value(const std::vector<CommandLineOptionPtr>& options,
+                               std::uint32_t spec_index) {
+  return spec_index != internal::OptionIndex::npos &&
+         options[spec_index]->consumes_next_positional_arg();
 }
 
 void Parser::check_name_availability(const std::string& name,
-                                     const std::string& short_name) const {
+                                     const std::string& short_name,
+                                     const std::string& env_var) const {
   if (reserved_names.count(name) != 0) {
     internal::throw_logic_error(
         "Argument tried to register " + name +
@@ -226,78 +1024,10 @@ void Parser::check_name_availability(const std::string& name,
     internal::throw_logic_error(
         "Argument short name should always have length 1.");
   }
-}
-
-void Parser::add_choice_argument_help(
-    const std::optional<internal::Generator>& default_value,
-    const std::optional<internal::Generator>& implicit_value,
-    const std::string& help_group, const std::string& name,
-    const std::string& short_name, const std::string& description,
-    const std::string& rendered_options) {
-  std::string extra;
-  if (default_value.has_value() && implicit_value.has_value()) {
-    extra = "Default: '" + default_value.value().get_description() +
-            "', Implicit: '" + implicit_value.value().get_description() +
-            "', allowed values: " + rendered_options;
-  } else if (default_value.has_value()) {
-    extra = "Default: '" + default_value.value().get_description() +
-            "', allowed values: " + rendered_options;
-  } else if (implicit_value.has_value()) {
-    extra = "Implicit: '" + implicit_value.value().get_description() +
-            "', allowed values: " + rendered_options;
-  }
-  add_help(help_group, name, short_name, description, extra);
-}
-
-void Parser::add_numeric_argument_help(
-    const std::optional<internal::Generator>& default_value,
-    const std::optional<internal::Generator>& implicit_value,
-    const std::string& help_group, const std::string& name,
-    const std::string& short_name, const std::string& description) {
-  std::string extra;
-  if (default_value.has_value() && implicit_value.has_value()) {
-    extra = "Default: '" + default_value.value().get_description() +
-            "', Implicit: '" + implicit_value.value().get_description() + "'";
-  } else if (default_value.has_value()) {
-    extra = "Default: '" + default_value.value().get_description() + "'";
-  } else if (implicit_value.has_value()) {
-    extra = "Implicit: '" + implicit_value.value().get_description() + "'";
-  }
-  add_help(help_group, name, short_name, description, extra);
-}
-
-void Parser::add_help(const std::string& help_group, const std::string& name,
-                      const std::string& short_name,
-                      const std::string& description,
-                      const std::string& extra) {
-  std::string help_line = "\t--" + name;
-  if (!short_name.empty()) {
-    help_line += ",-" + short_name;
-  }
-  if (!description.empty()) {
-    help_line += "  ";
-  }
-  help_line += description;
-  if (!extra.empty()) {
-    help_line += description.empty() ? "  " : "\n\t\t";
-    help_line += extra;
-  }
-
-  if (help_group.empty()) {
-    help_prefix += "\n" + help_line;
-    return;
-  }
-
-  bool found_help_group = false;
-  for (HelpGroup& group: help_sections) {
-    if (group.group_name == help_group) {
-      found_help_group = true;
-      group.content += help_line + "\n";
-      break;
-    }
-  }
-  if (!found_help_group) {
-    help_sections.push_back({help_group, help_group + "\n" + help_line + "\n"});
+  if (!env_var.empty() && reserved_env_vars.count(env_var) != 0) {
+    internal::throw_logic_error(
+        "Argument tried to read the environment variable " + env_var +
+        ", but a different argument already reads it.");
   }
 }
 
@@ -0,0 +1,74 @@
+#include <mcga/cli/response_files.hpp>
+
+#include <algorithm>
+#include <cctype>
+
+#include <mcga/cli/exceptions.hpp>
+
+namespace mcga::cli::internal {
+
+void ResponseFiles::clear() {
+  files.clear();
+  open_files.clear();
+}
+
+bool ResponseFiles::next_token(std::span<char>& remaining,
+                               std::string_view& token) {
+  char* it = remaining.data();
+  char* end = it + remaining.size();
+  while (it != end && std::isspace(static_cast<unsigned char>(*it)) != 0) {
+    ++it;
+  }
+  if (it == end) {
+    remaining = {end, end};
+    return false;
+  }
+
+  // unquoting only ever shrinks the token, so it is written over itself.
+  // Characters are only written once the token has shrunk, so that pages
+  // without quotes or escapes are never copied.
+  char* token_begin = it;
+  char* out = it;
+  char quote = 0;
+  for (; it != end; ++it) {
+    char c = *it;
+    if (quote == 0 && std::isspace(static_cast<unsigned char>(c)) != 0) {
+      break;
+    }
+    if (c == '\\' && quote != '\'' && it + 1 != end) {
+      c = *++it;
+    } else if (quote == 0 && (c == '\'' || c == '"')) {
+      quote = c;
+      continue;
+    } else if (c == quote) {
+      quote = 0;
+      continue;
+    }
+    if (out != it) {
+      *out = c;
+    }
+    ++out;
+  }
+  token = {token_begin, static_cast<std::size_t>(out - token_begin)};
+  remaining = {it, end};
+  return true;
+}
+
+const MappedFile* ResponseFiles::open(std::string_view path) {
+  std::error_code error;
+  std::filesystem::path file_path =
+      std::filesystem::canonical(std::filesystem::path(path), error);
+  if (error || !std::filesystem::is_regular_file(file_path, error)) {
+    return nullptr;
+  }
+  if (std::find(open_files.begin(), open_files.end(), file_path) !=
+      open_files.end()) {
+    throw_invalid_argument_exception("Response file " + file_path.string() +
+                                     " includes itself.");
+  }
+  files.push_back(std::make_unique<MappedFile>(file_path));
+  open_files.push_back(std::move(file_path));
+  return files.back().get();
+}
+
+} // namespace mcga::cli::internal
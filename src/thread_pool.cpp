@@ -0,0 +1,100 @@
+#include <mcga/cli/thread_pool.hpp>
+
+#include <algorithm>
+
+namespace mcga::cli::internal {
+
+ThreadPool::ThreadPool(std::size_t num_threads) {
+  num_threads = std::max<std::size_t>(num_threads, 1);
+  queues.reserve(num_threads);
+  for (std::size_t i = 0; i < num_threads; ++i) {
+    queues.push_back(std::make_unique<WorkerQueue>());
+  }
+  threads.reserve(num_threads);
+  for (std::size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back([this, i] {
+      run_worker(i);
+    });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard guard(sleep_mutex);
+    stopping = true;
+  }
+  wake_up.notify_all();
+  for (std::thread& thread: threads) {
+    thread.join();
+  }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+  // count the task before publishing it, so that a worker that pops it right
+  // away never decrements the counter below zero.
+  {
+    std::lock_guard guard(sleep_mutex);
+    num_pending += 1;
+  }
+  WorkerQueue& queue = *queues[next_queue++ % queues.size()];
+  {
+    std::lock_guard guard(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+  wake_up.notify_one();
+}
+
+std::size_t ThreadPool::size() const {
+  return threads.size();
+}
+
+ThreadPool& ThreadPool::shared() {
+  static ThreadPool pool(std::thread::hardware_concurrency());
+  return pool;
+}
+
+void ThreadPool::run_worker(std::size_t worker_id) {
+  std::function<void()> task;
+  while (true) {
+    if (try_pop(worker_id, task)) {
+      {
+        std::lock_guard guard(sleep_mutex);
+        num_pending -= 1;
+      }
+      task();
+      task = nullptr;
+      continue;
+    }
+    std::unique_lock lock(sleep_mutex);
+    wake_up.wait(lock, [this] {
+      return stopping || num_pending > 0;
+    });
+    if (stopping && num_pending == 0) {
+      return;
+    }
+  }
+}
+
+bool ThreadPool::try_pop(std::size_t worker_id, std::function<void()>& task) {
+  {
+    WorkerQueue& own_queue = *queues[worker_id];
+    std::lock_guard guard(own_queue.mutex);
+    if (!own_queue.tasks.empty()) {
+      task = std::move(own_queue.tasks.back());
+      own_queue.tasks.pop_back();
+      return true;
+    }
+  }
+  for (std::size_t i = 1; i < queues.size(); ++i) {
+    WorkerQueue& victim = *queues[(worker_id + i) % queues.size()];
+    std::lock_guard guard(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace mcga::cli::internal
@@ -0,0 +1,86 @@
+#include "allocation_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::size_t> allocations = 0;
+
+void* allocate(std::size_t size) noexcept {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void* allocate_aligned(std::size_t size, std::align_val_t alignment) noexcept {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  auto align = static_cast<std::size_t>(alignment);
+  // aligned_alloc needs a size that is a multiple of the alignment.
+  return std::aligned_alloc(align, (size + align - 1) / align * align);
+}
+
+} // namespace
+
+namespace mcga::cli::test {
+
+std::size_t global_allocations() {
+  return allocations.load(std::memory_order_relaxed);
+}
+
+} // namespace mcga::cli::test
+
+// Every allocation is served by malloc (or aligned_alloc), so that each
+// replaced operator delete can release the memory with free. The array forms
+// are not replaced: by default, they call the forms below.
+
+void* operator new(std::size_t size) {
+  void* ptr = allocate(size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t& /*tag*/) noexcept {
+  return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  void* ptr = allocate_aligned(size, alignment);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment,
+                   const std::nothrow_t& /*tag*/) noexcept {
+  return allocate_aligned(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t& /*tag*/) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t /*alignment*/) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/,
+                     std::align_val_t /*alignment*/) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t /*alignment*/,
+                     const std::nothrow_t& /*tag*/) noexcept {
+  std::free(ptr);
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+namespace mcga::cli::test {
+
+// The number of allocations made through the global operator new so far, by
+// all threads. The test binary replaces the global operator new and delete to
+// count them, see allocation_counter.cpp.
+std::size_t global_allocations();
+
+// Run `fn`, and return the number of global allocations it made.
+template<class Fn>
+std::size_t count_allocations(Fn&& fn) {
+  std::size_t before = global_allocations();
+  fn();
+  return global_allocations() - before;
+}
+
+} // namespace mcga::cli::test
@@ -0,0 +1,207 @@
+#include <array>
+#include <string>
+#include <vector>
+
+#include <mcga/test.hpp>
+#include <mcga/test_ext/matchers.hpp>
+
+#include "mcga/cli.hpp"
+
+#include "allocation_counter.hpp"
+
+using mcga::cli::Argument;
+using mcga::cli::ArgumentSpec;
+using mcga::cli::ChoiceArgumentSpec;
+using mcga::cli::Flag;
+using mcga::cli::FlagSpec;
+using mcga::cli::ListArgumentSpec;
+using mcga::cli::NumericArgument;
+using mcga::cli::NumericArgumentSpec;
+using mcga::cli::Parser;
+using mcga::cli::test::count_allocations;
+using mcga::matchers::isEqualTo;
+using mcga::matchers::isTrue;
+
+TEST_CASE("Allocations") {
+  std::unique_ptr<Parser> parser;
+
+  setUp([&] {
+    parser = std::make_unique<Parser>("Help prefix.");
+  });
+
+  tearDown([&] {
+    parser.reset();
+  });
+
+  group("Flags and numeric options", [&] {
+    std::vector<Flag> flags;
+    NumericArgument<int> count;
+    NumericArgument<double> ratio;
+    NumericArgument<long long> size;
+
+    setUp([&] {
+      flags.clear();
+      for (char name = 'a'; name <= 'h'; ++name) {
+        std::string short_name(1, name);
+        flags.push_back(parser->add_flag(
+            FlagSpec("flag-" + short_name).set_short_name(short_name)));
+      }
+      count = parser->add_numeric_argument<int>(
+          NumericArgumentSpec("count").set_default_value("1"));
+      ratio = parser->add_numeric_argument<double>(
+          NumericArgumentSpec("ratio").set_default_value("0.25"));
+      size = parser->add_numeric_argument<long long>(
+          NumericArgumentSpec("size").set_short_name("s").set_default_value(
+              "1_000_000"));
+    });
+
+    test("Parsing again allocates nothing", [&] {
+      std::array<std::string_view, 6> args{
+          "-abc", "--count=3", "--ratio=0.5", "-d", "-s", "0x10"};
+      parser->parse(args);
+
+      expect(count_allocations([&] {
+               parser->parse(args);
+             }),
+             isEqualTo(0));
+      expect(flags[2]->get_value(), isTrue);
+      expect(count->get_value(), isEqualTo(3));
+      expect(size->get_value(), isEqualTo(16));
+    });
+
+    test("Resetting and applying the defaults allocates nothing", [&] {
+      std::array<std::string_view, 0> args{};
+      parser->parse(args);
+
+      expect(count_allocations([&] {
+               parser->parse(args);
+             }),
+             isEqualTo(0));
+      expect(ratio->get_value(), isEqualTo(0.25));
+      expect(size->get_value(), isEqualTo(1000000));
+    });
+
+    test("Every overload of parse allocates nothing", [&] {
+      Parser::ArgList arg_list{"--count=3", "-ef"};
+      std::array<const char*, 2> argv{"--ratio=2", "-gh"};
+      parser->parse(arg_list);
+      parser->parse(argv);
+
+      expect(count_allocations([&] {
+               parser->parse(arg_list);
+               parser->parse(argv);
+             }),
+             isEqualTo(0));
+    });
+
+    test("Collecting statistics allocates nothing after warm-up", [&] {
+      std::array<std::string_view, 2> args{"-a", "--count=3"};
+      parser->enable_parse_stats();
+      parser->parse(args);
+
+      expect(count_allocations([&] {
+               parser->parse(args);
+             }),
+             isEqualTo(0));
+      expect(parser->last_parse_stats().defaults_evaluated, isEqualTo(9));
+    });
+  });
+
+  group("Setting the value of", [&] {
+    test("an argument reuses its storage", [&] {
+      auto arg = parser->add_argument(ArgumentSpec("name"));
+      std::array<std::string_view, 1> args{
+          "--name=a value too long for the small string buffer"};
+      parser->parse(args);
+
+      expect(count_allocations([&] {
+               parser->parse(args);
+             }),
+             isEqualTo(0));
+      expect(arg->get_value_view().size(), isEqualTo(args[0].size() - 7));
+    });
+
+    test("a choice argument allocates nothing", [&] {
+      auto arg = parser->add_choice_argument(
+          ChoiceArgumentSpec<int>("level").set_case_insensitive().set_options(
+              {{"low", 1}, {"high", 2}}));
+      std::array<std::string_view, 1> args{"--level=HIGH"};
+      parser->parse(args);
+
+      expect(count_allocations([&] {
+               parser->parse(args);
+             }),
+             isEqualTo(0));
+      expect(arg->get_value(), isEqualTo(2));
+    });
+
+    test("a numeric list reuses its storage", [&] {
+      auto arg = parser->add_list_argument(
+          ListArgumentSpec<NumericArgument<int>>("ids").set_delimiter(','));
+      std::string values = "--ids=0";
+      for (int i = 1; i < 100; ++i) {
+        values += "," + std::to_string(i);
+      }
+      std::array<std::string_view, 2> args{values, "--ids=100"};
+      parser->parse(args);
+
+      expect(count_allocations([&] {
+               parser->parse(args);
+             }),
+             isEqualTo(0));
+      expect(arg->get_value_view().size(), isEqualTo(101));
+    });
+
+    test("a string list allocates one string per long element", [&] {
+      auto arg = parser->add_list_argument(ListArgumentSpec("names"));
+      std::array<std::string_view, 3> args{
+          "--names=short",
+          "--names=a value too long for the small string buffer",
+          "--names=another value too long for the small string buffer"};
+      parser->parse(args);
+
+      expect(count_allocations([&] {
+               parser->parse(args);
+             }),
+             isEqualTo(2));
+      expect(arg->get_value_view().size(), isEqualTo(3));
+    });
+  });
+
+  test("Registering a flag does not copy the flag values", [&] {
+    auto count_flag_allocations = [](const std::string& name) {
+      FlagSpec spec(name);
+      return count_allocations([&] {
+        mcga::cli::internal::FlagImpl flag(spec);
+      });
+    };
+    // the first flag creates the table shared by all of them.
+    static_cast<void>(count_flag_allocations("warm-up"));
+
+    std::size_t allocations = count_flag_allocations("first");
+    expect(count_flag_allocations("second"), isEqualTo(allocations));
+    expect(allocations < std::size(mcga::cli::internal::flag_values), isTrue);
+  });
+
+  test("Rendering the help allocates only the first time", [&] {
+    parser->add_argument(
+        ArgumentSpec("name").set_description("A name.").set_default_value("a"));
+
+    expect(count_allocations([&] {
+             static_cast<void>(parser->render_help());
+             static_cast<void>(parser->render_help(80));
+           }) > 0,
+           isTrue);
+    expect(count_allocations([&] {
+             static_cast<void>(parser->render_help());
+             static_cast<void>(parser->render_help(80));
+           }),
+           isEqualTo(0));
+
+    parser->add_flag(FlagSpec("verbose"));
+    expect(count_allocations([&] {
+             static_cast<void>(parser->render_help());
+           }) > 0,
+           isTrue);
+  });
+}
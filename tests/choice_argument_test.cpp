@@ -1,3 +1,6 @@
+#include <map>
+#include <string>
+
 #include <mcga/test.hpp>
 #include <mcga/test_ext/matchers.hpp>
 
@@ -6,6 +9,7 @@
 using mcga::cli::ChoiceArgumentSpec;
 using mcga::cli::Parser;
 using mcga::matchers::isEqualTo;
+using mcga::matchers::isTrue;
 using mcga::matchers::throwsA;
 
 TEST_CASE("Choice argument") {
@@ -77,4 +81,105 @@ TEST_CASE("Choice argument") {
     expect(spec.options,
            isEqualTo(std::map<std::string, int>{{"k", 12}, {"l", 14}}));
   });
-}
\ No newline at end of file
+
+  test("Choice argument with many options", [&] {
+    ChoiceArgumentSpec<int> spec("region");
+    for (int i = 0; i < 5000; ++i) {
+      spec.add_option("region-" + std::to_string(i), i);
+    }
+    auto arg = parser->add_choice_argument(spec);
+
+    for (int i: {0, 17, 999, 4999}) {
+      parser->parse({"--region=region-" + std::to_string(i)});
+      expect(arg->get_value(), isEqualTo(i));
+    }
+    for (const char* invalid:
+         {"--region=region-5000", "--region=region-", "--region="}) {
+      expect(
+          [&] {
+            parser->parse({invalid});
+          },
+          throwsA<std::invalid_argument>);
+    }
+  });
+
+  test("The options are listed in order when the value is invalid", [&] {
+    parser->add_choice_argument(
+        ChoiceArgumentSpec<int>("name").set_options({{"b", 2}, {"a", 1}}));
+    std::string message;
+    try {
+      parser->parse({"--name=c"});
+    } catch (const std::invalid_argument& error) {
+      message = error.what();
+    }
+    expect(message, isEqualTo("Trying to set option `c` to argument name, "
+                              "which has options ['a','b']"));
+  });
+
+  test("Case insensitive choice argument", [&] {
+    auto arg = parser->add_choice_argument(
+        ChoiceArgumentSpec<int>("level")
+            .set_case_insensitive()
+            .set_options({{"Low", 1}, {"high", 2}}));
+
+    parser->parse({"--level=LOW"});
+    expect(arg->get_value(), isEqualTo(1));
+
+    parser->parse({"--level=High"});
+    expect(arg->get_value(), isEqualTo(2));
+
+    expect(
+        [&] {
+          parser->parse({"--level=medium"});
+        },
+        throwsA<std::invalid_argument>);
+  });
+
+  test("Case insensitive options must differ by more than case", [&] {
+    expect(
+        [&] {
+          parser->add_choice_argument(
+              ChoiceArgumentSpec<int>("level")
+                  .set_case_insensitive()
+                  .set_options({{"low", 1}, {"LOW", 2}}));
+        },
+        throwsA<std::logic_error>);
+  });
+
+  test("The spec and the instances share the frozen options", [&] {
+    auto arg = parser->add_choice_argument(
+        ChoiceArgumentSpec<int>("level").set_options(
+            {{"low", 1}, {"high", 2}}));
+    const auto& spec = arg->get_spec();
+    expect(spec.options.empty(), isTrue);
+    expect(spec.get_options(),
+           isEqualTo(std::map<std::string, int>{{"high", 2}, {"low", 1}}));
+
+    auto result = parser->freeze()->parse({"--level=high"});
+    expect(result.get(arg), isEqualTo(2));
+
+    // registering a frozen spec with more options builds a new table.
+    Parser other("");
+    auto extended = other.add_choice_argument(
+        ChoiceArgumentSpec<int>(spec).add_option("low", 0).add_option(
+            "medium", 3));
+    expect(extended->get_spec().get_options(),
+           isEqualTo(std::map<std::string, int>{
+               {"high", 2}, {"low", 0}, {"medium", 3}}));
+    expect(spec.get_options().size(), isEqualTo(2));
+  });
+
+  test("Values can be viewed without copying them", [&] {
+    auto arg = parser->add_choice_argument(
+        ChoiceArgumentSpec<std::string>("level")
+            .set_options({{"low", "a low level"}, {"high", "a high level"}})
+            .set_default_value("low"));
+
+    parser->parse({});
+    expect(arg->get_value_view(), isEqualTo("a low level"));
+    expect(arg->get_value_view_if_exists() == nullptr, isTrue);
+
+    parser->parse({"--level=high"});
+    expect(*arg->get_value_view_if_exists(), isEqualTo("a high level"));
+  });
+}
@@ -1,3 +1,6 @@
+#include <map>
+#include <string>
+
 #include <mcga/test.hpp>
 #include <mcga/test_ext/matchers.hpp>
 
@@ -46,6 +49,13 @@ TEST_CASE("Flag") {
     expect(b->get_value(), isTrue);
   });
 
+  test("Long single dash clusters", [&] {
+    auto positional = parser->parse({"-aaaaaaaaaaaaaaaaaaaaaaaaaab", "p"});
+    expect(a->get_value(), isTrue);
+    expect(b->get_value(), isTrue);
+    expect(positional, isEqualTo(std::vector<std::string>{"p"}));
+  });
+
   test("Passing a flag value 'enabled' enables it", [&] {
     parser->parse({"--flag_a=enabled"});
     expect(a->get_value(), isTrue);
@@ -66,4 +76,45 @@ TEST_CASE("Flag") {
          expect(positional, isEqualTo(std::vector<std::string>{"enabled"}));
          expect(a->get_value(), isTrue);
        });
+
+  test("Flag values are matched ignoring case", [&] {
+    parser->parse({"--flag_a=True"});
+    expect(a->get_value(), isTrue);
+
+    parser->parse({"--flag_a=DISABLED"});
+    expect(a->get_value(), isFalse);
+
+    parser->parse({"--flag_a=eNaBlEd"});
+    expect(a->get_value(), isTrue);
+  });
+
+  test("The spec of a flag lists its accepted values", [&] {
+    expect(a->get_spec().get_options(),
+           isEqualTo(std::map<std::string, bool>{{"0", false},
+                                                 {"1", true},
+                                                 {"disabled", false},
+                                                 {"enabled", true},
+                                                 {"false", false},
+                                                 {"true", true}}));
+  });
+
+  test("Invalid flag values list the accepted values", [&] {
+    std::string message;
+    try {
+      parser->parse({"--flag_a=yes"});
+    } catch (const std::invalid_argument& error) {
+      message = error.what();
+    }
+    expect(message, isEqualTo("Trying to set option `yes` to argument flag_a, "
+                              "which has options ['0','1','disabled',"
+                              "'enabled','false','true']"));
+  });
+
+  test("Flag values can be viewed without copying them", [&] {
+    parser->parse({"-a"});
+    expect(a->get_value_view(), isTrue);
+    expect(*a->get_value_view_if_exists(), isTrue);
+    expect(b->get_value_view(), isFalse);
+    expect(b->get_value_view_if_exists() == nullptr, isTrue);
+  });
 }
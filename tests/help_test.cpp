@@ -6,10 +6,12 @@
 #include "mcga/cli.hpp"
 
 using mcga::cli::ArgumentSpec;
+using mcga::cli::ChoiceArgumentSpec;
 using mcga::cli::FlagSpec;
 using mcga::cli::NumericArgumentSpec;
 using mcga::cli::Parser;
 using mcga::matchers::isEqualTo;
+using mcga::matchers::isTrue;
 
 TEST_CASE("Help") {
   std::unique_ptr<Parser> parser;
@@ -149,4 +151,78 @@ TEST_CASE("Help") {
                      "\t--vm-heap  Interpreter VM max heap size\n"
                      "\t\tDefault: '1000', Implicit: '1000'\n"));
   });
-}
\ No newline at end of file
+
+  test("Rendered twice, the help is built only once", [&] {
+    const std::string& help = parser->render_help();
+    expect(&parser->render_help() == &help, isTrue);
+    parser->add_flag(FlagSpec("version").set_short_name("v"));
+    expect(parser->render_help(),
+           isEqualTo("Test help prefix.\n"
+                     "\n"
+                     "\t--help,-h  Display this help menu.\n"
+                     "\t--version,-v\n"));
+  });
+
+  test("Choice arguments list their allowed values", [&] {
+    parser->add_choice_argument(
+        ChoiceArgumentSpec<int>("level")
+            .set_description("Log level")
+            .set_options({{"low", 1}, {"high", 2}})
+            .set_default_value("low"));
+    expect(parser->render_help(),
+           isEqualTo("Test help prefix.\n"
+                     "\n"
+                     "\t--help,-h  Display this help menu.\n"
+                     "\t--level  Log level\n"
+                     "\t\tDefault: 'low', allowed values: ['high','low']\n"));
+  });
+
+  test("With a width, names and descriptions are aligned", [&] {
+    parser->add_flag(FlagSpec("version")
+                         .set_description("Display program version")
+                         .set_short_name("v"));
+    parser->add_numeric_argument<int>(
+        NumericArgumentSpec("vm-heap")
+            .set_description("Interpreter VM max heap size")
+            .set_help_group("Runtime")
+            .set_default_value("1000"));
+    expect(parser->render_help(80),
+           isEqualTo("Test help prefix.\n"
+                     "\n"
+                     "  --help,-h     Display this help menu.\n"
+                     "  --version,-v  Display program version\n"
+                     "\n"
+                     "Runtime\n"
+                     "  --vm-heap     Interpreter VM max heap size\n"
+                     "                Default: '1000'\n"));
+  });
+
+  test("With a width, descriptions are wrapped", [&] {
+    parser->add_argument(
+        ArgumentSpec("config")
+            .set_description("File to take the configuration of the whole "
+                             "program from")
+            .set_default_value("/path/to/default-config.txt"));
+    expect(parser->render_help(40),
+           isEqualTo("Test help prefix.\n"
+                     "\n"
+                     "  --help,-h  Display this help menu.\n"
+                     "  --config   File to take the\n"
+                     "             configuration of the whole\n"
+                     "             program from\n"
+                     "             Default:\n"
+                     "             '/path/to/default-config.txt'\n"));
+  });
+
+  test("With a narrow width, descriptions go below long names", [&] {
+    parser->add_flag(FlagSpec("a-rather-long-flag-name")
+                         .set_description("Short description"));
+    expect(parser->render_help(30),
+           isEqualTo("Test help prefix.\n"
+                     "\n"
+                     "  --help,-h  Display this help\n"
+                     "             menu.\n"
+                     "  --a-rather-long-flag-name\n"
+                     "             Short description\n"));
+  });
+}
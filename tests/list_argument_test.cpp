@@ -1,3 +1,6 @@
+#include <span>
+#include <vector>
+
 #include <mcga/test.hpp>
 #include <mcga/test_ext/matchers.hpp>
 
@@ -7,6 +10,8 @@ using mcga::cli::ListArgumentSpec;
 using mcga::cli::NumericArgument;
 using mcga::cli::Parser;
 using mcga::matchers::isEqualTo;
+using mcga::matchers::isFalse;
+using mcga::matchers::isTrue;
 using mcga::matchers::throwsA;
 
 TEST_CASE("List argument") {
@@ -103,4 +108,61 @@ TEST_CASE("List argument") {
          parser->parse({"--name=3", "--name", "--name=4", "--name=5"});
          expect(arg->get_value(), isEqualTo(std::vector<int>{3, 1, 2, 4, 5}));
        });
+
+  test("Values are split on the delimiter", [&] {
+    auto arg = parser->add_list_argument(
+        ListArgumentSpec("name").set_delimiter(',').set_default_value(
+            {"x,y"}));
+
+    parser->parse({});
+    expect(arg->get_value(), isEqualTo(std::vector<std::string>{"x", "y"}));
+
+    parser->parse({"--name=a,b", "--name=c", "--name=d,,e"});
+    expect(arg->get_value(), isEqualTo(std::vector<std::string>{
+                                 "a", "b", "c", "d", "", "e"}));
+  });
+
+  test("NumericArgument: Values are split on the delimiter", [&] {
+    auto arg = parser->add_list_argument(
+        ListArgumentSpec<NumericArgument<int>>("name").set_delimiter(','));
+
+    parser->parse({"--name=1,2,0x10", "--name=-4"});
+    expect(arg->get_value(), isEqualTo(std::vector<int>{1, 2, 16, -4}));
+
+    for (const char* invalid: {"--name=1,,2", "--name=1,", "--name=1;2"}) {
+      expect(
+          [&] {
+            parser->parse({invalid});
+          },
+          throwsA<std::invalid_argument>);
+    }
+  });
+
+  test("Values can be viewed without copying them", [&] {
+    auto arg = parser->add_list_argument(
+        ListArgumentSpec<NumericArgument<int>>("name")
+            .set_delimiter(',')
+            .set_default_value({}));
+
+    parser->parse({});
+    expect(arg->get_value_view().empty(), isTrue);
+    expect(arg->get_value_view_if_exists().has_value(), isFalse);
+
+    parser->parse({"--name=1,2,3"});
+    std::span<const int> values = arg->get_value_view();
+    expect(std::vector<int>(values.begin(), values.end()),
+           isEqualTo(std::vector<int>{1, 2, 3}));
+    expect(arg->get_value_view_if_exists()->data(), isEqualTo(values.data()));
+  });
+
+  test("Flag lists can be viewed without copying them", [&] {
+    auto arg = parser->add_list_argument(
+        ListArgumentSpec<mcga::cli::Flag>("name").set_default_value({}));
+
+    parser->parse({"--name=true", "--name=false"});
+    const auto& values = arg->get_value_view();
+    expect(std::vector<bool>(values.begin(), values.end()),
+           isEqualTo(std::vector<bool>{true, false}));
+    expect(arg->get_value_view_if_exists(), isEqualTo(&values));
+  });
 }
@@ -0,0 +1,181 @@
+#include <array>
+#include <functional>
+#include <memory_resource>
+#include <string>
+
+#include <mcga/test.hpp>
+#include <mcga/test_ext/matchers.hpp>
+
+#include "mcga/cli.hpp"
+
+#include "allocation_counter.hpp"
+
+using mcga::cli::ArgumentSpec;
+using mcga::cli::FlagSpec;
+using mcga::cli::ListArgumentSpec;
+using mcga::cli::NumericArgument;
+using mcga::cli::NumericArgumentSpec;
+using mcga::cli::Parser;
+using mcga::cli::test::count_allocations;
+using mcga::matchers::isEqualTo;
+using mcga::matchers::isTrue;
+
+namespace {
+
+// Counts the allocations made through it, and serves them from `upstream`.
+class CountingResource: public std::pmr::memory_resource {
+public:
+  explicit CountingResource(std::pmr::memory_resource* upstream_)
+      : upstream(upstream_) {}
+
+  std::size_t allocations = 0;
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    return upstream->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* ptr, std::size_t bytes,
+                     std::size_t alignment) override {
+    upstream->deallocate(ptr, bytes, alignment);
+  }
+
+  [[nodiscard]] bool
+      do_is_equal(const std::pmr::memory_resource& other) const noexcept
+      override {
+    return this == &other;
+  }
+
+  std::pmr::memory_resource* upstream;
+};
+
+} // namespace
+
+TEST_CASE("Memory resource") {
+  // the arena has no upstream, so an allocation that does not fit in the
+  // buffer throws instead of silently reaching the global heap.
+  std::unique_ptr<std::array<std::byte, 1 << 16>> buffer;
+  std::unique_ptr<std::pmr::monotonic_buffer_resource> arena;
+  std::unique_ptr<CountingResource> resource;
+  std::unique_ptr<Parser> parser;
+
+  setUp([&] {
+    buffer = std::make_unique<std::array<std::byte, 1 << 16>>();
+    arena = std::make_unique<std::pmr::monotonic_buffer_resource>(
+        buffer->data(), buffer->size(), std::pmr::null_memory_resource());
+    resource = std::make_unique<CountingResource>(arena.get());
+    parser = std::make_unique<Parser>("Help prefix.", resource.get());
+  });
+
+  tearDown([&] {
+    parser.reset();
+    resource.reset();
+    arena.reset();
+    buffer.reset();
+  });
+
+  test("Registered options are allocated from the resource", [&] {
+    parser->add_flag(FlagSpec("verbose").set_short_name("v"));
+    std::size_t flag_allocations = resource->allocations;
+    parser->add_numeric_argument<int>(
+        NumericArgumentSpec("count").set_default_value("1"));
+
+    expect(flag_allocations > 0, isTrue);
+    expect(resource->allocations > flag_allocations, isTrue);
+  });
+
+  test("Parsing again does not use the global heap", [&] {
+    auto flag = parser->add_flag(FlagSpec("verbose").set_short_name("v"));
+    auto count = parser->add_numeric_argument<int>(
+        NumericArgumentSpec("count").set_default_value("1"));
+    auto name =
+        parser->add_argument(ArgumentSpec("name").set_default_value("none"));
+    auto values = parser->add_list_argument<NumericArgument<int>>(
+        ListArgumentSpec<NumericArgument<int>>("values").set_delimiter(','));
+    std::array<std::string_view, 5> args{
+        "-v", "--count=3", "--name=value", "--values=1,2,3,4", "positional"};
+
+    // the first parse sizes the values of the options.
+    static_cast<void>(parser->parse(args, resource.get()));
+    std::size_t resource_allocations = resource->allocations;
+    Parser::PmrArgViewList positional(resource.get());
+    std::size_t heap_allocations = count_allocations([&] {
+      positional = parser->parse(args, resource.get());
+    });
+
+    expect(heap_allocations, isEqualTo(0));
+    expect(resource->allocations > resource_allocations, isTrue);
+    expect(positional.size(), isEqualTo(1));
+    expect(positional[0], isEqualTo("positional"));
+    expect(flag->get_value(), isTrue);
+    expect(count->get_value(), isEqualTo(3));
+    expect(name->get_value(), isEqualTo("value"));
+    expect(values->get_value(), isEqualTo(std::vector<int>{1, 2, 3, 4}));
+  });
+
+  test("Defaults do not use the global heap either", [&] {
+    auto count = parser->add_numeric_argument<int>(
+        NumericArgumentSpec("count").set_default_value("1"));
+    auto name =
+        parser->add_argument(ArgumentSpec("name").set_default_value("none"));
+    std::array<std::string_view, 0> args{};
+
+    static_cast<void>(parser->parse(args, resource.get()));
+    std::size_t heap_allocations = count_allocations([&] {
+      static_cast<void>(parser->parse(args, resource.get()));
+    });
+
+    expect(heap_allocations, isEqualTo(0));
+    expect(count->get_value(), isEqualTo(1));
+    expect(name->get_value(), isEqualTo("none"));
+  });
+
+  test("Schema parses allocate from their own resource", [&] {
+    auto name =
+        parser->add_argument(ArgumentSpec("name").set_default_value("none"));
+    auto schema = parser->freeze();
+    std::size_t parser_allocations = resource->allocations;
+
+    std::pmr::monotonic_buffer_resource request_arena;
+    CountingResource request_resource(&request_arena);
+    auto result = schema->parse({"--name=a value too long for the buffer"},
+                                &request_resource);
+
+    expect(result.get(name), isEqualTo("a value too long for the buffer"));
+    expect(request_resource.allocations > 0, isTrue);
+    expect(resource->allocations, isEqualTo(parser_allocations));
+  });
+
+  test("Defaults are generated concurrently only on thread-safe resources",
+       [&] {
+         int num_tasks = 0;
+         auto executor = [&](const std::function<void()>& task) {
+           num_tasks += 1;
+           task();
+         };
+         auto add_generators = [](Parser& target) {
+           for (std::string name: {"first", "second"}) {
+             target.add_argument(ArgumentSpec(name)
+                                     .set_default_value_generator([] {
+                                       return std::string("generated");
+                                     })
+                                     .set_independent_default_value());
+           }
+         };
+         add_generators(*parser);
+         parser->enable_concurrent_defaults(executor);
+         parser->parse({});
+         expect(num_tasks, isEqualTo(0));
+
+         std::pmr::synchronized_pool_resource pool;
+         auto result = parser->freeze()->parse({}, &pool);
+         expect(num_tasks, isEqualTo(2));
+
+         Parser heap_parser("");
+         add_generators(heap_parser);
+         heap_parser.enable_concurrent_defaults(executor);
+         heap_parser.parse({});
+         expect(num_tasks, isEqualTo(4));
+       });
+}
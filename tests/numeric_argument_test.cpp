@@ -1,3 +1,6 @@
+#include <cmath>
+#include <limits>
+
 #include <mcga/test.hpp>
 #include <mcga/test_ext/matchers.hpp>
 
@@ -6,6 +9,7 @@
 using mcga::cli::NumericArgumentSpec;
 using mcga::cli::Parser;
 using mcga::matchers::isEqualTo;
+using mcga::matchers::isTrue;
 using mcga::matchers::throwsA;
 
 TEST_CASE("Numeric argument") {
@@ -54,4 +58,142 @@ TEST_CASE("Numeric argument") {
          parser->parse({"--name=12345678912345"});
          expect(arg->get_value(), isEqualTo(12345678912345LL));
        });
+
+  test("Integers with a radix prefix are parsed in that radix", [&] {
+    auto arg = parser->add_numeric_argument<int>(NumericArgumentSpec("name"));
+
+    parser->parse({"--name=0x1F"});
+    expect(arg->get_value(), isEqualTo(31));
+
+    parser->parse({"--name=-0o17"});
+    expect(arg->get_value(), isEqualTo(-15));
+
+    parser->parse({"--name=0b101"});
+    expect(arg->get_value(), isEqualTo(5));
+
+    parser->parse({"--name=017"});
+    expect(arg->get_value(), isEqualTo(17));
+  });
+
+  test("Digits of integers can be separated by underscores", [&] {
+    auto arg = parser->add_numeric_argument<long long>(
+        NumericArgumentSpec("name"));
+
+    parser->parse({"--name=1_000_000_000_000"});
+    expect(arg->get_value(), isEqualTo(1000000000000LL));
+
+    parser->parse({"--name=0xFF_FF"});
+    expect(arg->get_value(), isEqualTo(65535LL));
+
+    parser->parse({"--name=-0b1000_0000_0000_0000_0000_0000_0000_0000_0000_0000"
+                   "_0000_0000_0000_0000_0000_0000"});
+    expect(arg->get_value(), isEqualTo(std::numeric_limits<long long>::min()));
+
+    parser->parse({"--name=000_000_000_000_000_000_000_000_000_000_000_000_000"
+                   "_000_000_000_000_000_000_000_000_000_000_000_000_012"});
+    expect(arg->get_value(), isEqualTo(12LL));
+
+    parser->parse({"--name=1234567890123456"});
+    expect(arg->get_value(), isEqualTo(1234567890123456LL));
+
+    parser->parse({"--name=12345678901234567"});
+    expect(arg->get_value(), isEqualTo(12345678901234567LL));
+
+    for (const char* invalid: {"--name=_1", "--name=1_", "--name=1__0"}) {
+      expect(
+          [&] {
+            parser->parse({invalid});
+          },
+          throwsA<std::invalid_argument>);
+    }
+  });
+
+  test("Integers with trailing characters are rejected", [&] {
+    parser->add_numeric_argument<int>(NumericArgumentSpec("name"));
+    for (const char* invalid:
+         {"--name=12abc", "--name= 12", "--name=1.5", "--name=0x",
+          "--name=-", "--name=", "--name=0b102", "--name=123456789a"}) {
+      expect(
+          [&] {
+            parser->parse({invalid});
+          },
+          throwsA<std::invalid_argument>);
+    }
+  });
+
+  test("Integers are checked against the range of their type", [&] {
+    auto small = parser->add_numeric_argument<signed char>(
+        NumericArgumentSpec("small"));
+    auto count = parser->add_numeric_argument<unsigned short>(
+        NumericArgumentSpec("count"));
+    auto big = parser->add_numeric_argument<long long>(
+        NumericArgumentSpec("big"));
+
+    parser->parse({"--small=-128", "--count=65535",
+                   "--big=-9223372036854775808"});
+    expect(small->get_value(), isEqualTo(-128));
+    expect(count->get_value(), isEqualTo(65535));
+    expect(big->get_value(), isEqualTo(std::numeric_limits<long long>::min()));
+
+    for (const char* invalid:
+         {"--small=128", "--small=-129", "--count=65536", "--count=-1",
+          "--big=9223372036854775808", "--big=99999999999999999999",
+          "--big=0b1_0000_0000_0000_0000_0000_0000_0000_0000_0000_0000_0000"
+          "_0000_0000_0000_0000_0000_0000"}) {
+      expect(
+          [&] {
+            parser->parse({invalid});
+          },
+          throwsA<std::invalid_argument>);
+    }
+  });
+
+  test("Floating point values are parsed in full", [&] {
+    auto arg =
+        parser->add_numeric_argument<double>(NumericArgumentSpec("name"));
+
+    parser->parse({"--name=3.25"});
+    expect(arg->get_value(), isEqualTo(3.25));
+
+    parser->parse({"--name=+1e-3"});
+    expect(arg->get_value(), isEqualTo(1e-3));
+
+    parser->parse({"--name=-0x1.8p1"});
+    expect(arg->get_value(), isEqualTo(-3.0));
+
+    parser->parse({"--name=-inf"});
+    expect(arg->get_value(),
+           isEqualTo(-std::numeric_limits<double>::infinity()));
+
+    parser->parse({"--name=nan"});
+    expect(std::isnan(arg->get_value()), isTrue);
+
+    for (const char* invalid: {"--name=1.5abc", "--name=1,5", "--name=",
+                               "--name=+-1", "--name=0x", "--name=1e999"}) {
+      expect(
+          [&] {
+            parser->parse({invalid});
+          },
+          throwsA<std::invalid_argument>);
+    }
+  });
+
+  test("Float values are rounded to the nearest float", [&] {
+    auto arg = parser->add_numeric_argument<float>(NumericArgumentSpec("name"));
+    parser->parse({"--name=0.1"});
+    expect(arg->get_value(), isEqualTo(0.1F));
+  });
+
+  test("Values can be viewed without copying them", [&] {
+    auto arg = parser->add_numeric_argument<int>(
+        NumericArgumentSpec("name").set_default_value("3"));
+
+    parser->parse({});
+    expect(arg->get_value_view(), isEqualTo(3));
+    expect(arg->get_value_view_if_exists() == nullptr, isTrue);
+
+    parser->parse({"--name=4"});
+    expect(&arg->get_value_view() == arg->get_value_view_if_exists(), isTrue);
+    expect(*arg->get_value_view_if_exists(), isEqualTo(4));
+  });
 }
@@ -0,0 +1,135 @@
+#include <chrono>
+#include <thread>
+
+#include <mcga/test.hpp>
+#include <mcga/test_ext/matchers.hpp>
+
+#include "mcga/cli.hpp"
+
+using mcga::cli::Argument;
+using mcga::cli::ArgumentSpec;
+using mcga::cli::Flag;
+using mcga::cli::FlagSpec;
+using mcga::cli::Parser;
+using mcga::matchers::isEqualTo;
+using mcga::matchers::isTrue;
+
+TEST_CASE("Parse stats") {
+  std::unique_ptr<Parser> parser;
+  Flag flag;
+  Argument arg;
+  Argument slow;
+
+  setUp([&] {
+    parser = std::make_unique<Parser>("");
+    flag = parser->add_flag(FlagSpec("flag").set_short_name("f"));
+    arg = parser->add_argument(
+        ArgumentSpec("name").set_short_name("n").set_default_value("a"));
+    slow = parser->add_argument(
+        ArgumentSpec("slow").set_default_value_generator([] {
+          std::this_thread::sleep_for(std::chrono::milliseconds(2));
+          return "s";
+        }));
+  });
+
+  tearDown([&] {
+    parser.reset();
+  });
+
+  test("Nothing is collected by default", [&] {
+    parser->parse({"-f", "--name=x", "p"});
+    const auto& stats = parser->last_parse_stats();
+    expect(stats.tokens, isEqualTo(0));
+    expect(stats.lookups, isEqualTo(0));
+    expect(stats.generator_times.empty(), isTrue);
+    expect(stats.tokenize_time.count(), isEqualTo(0));
+  });
+
+  test("Tokens, lookups and appeared options are counted", [&] {
+    parser->enable_parse_stats();
+    parser->parse({"-f", "--name=x", "--unknown=y", "p"});
+    const auto& stats = parser->last_parse_stats();
+    // "-f" is pending until "--name=x" shows it has no value.
+    expect(stats.tokens, isEqualTo(4));
+    expect(stats.lookups, isEqualTo(3));
+    expect(stats.lookup_misses, isEqualTo(1));
+    expect(stats.appeared_options, isEqualTo(2));
+  });
+
+  test("A short name followed by its value is looked up once", [&] {
+    parser->enable_parse_stats();
+    parser->parse({"-n", "5"});
+    expect(parser->last_parse_stats().lookups, isEqualTo(1));
+    expect(arg->get_value(), isEqualTo("5"));
+  });
+
+  test("A short flag followed by positionals is looked up once", [&] {
+    parser->enable_parse_stats();
+    parser->parse({"-f", "p1", "p2", "p3"});
+    expect(parser->last_parse_stats().lookups, isEqualTo(1));
+
+    parser->begin();
+    for (const char* token: {"-f", "p1", "p2"}) {
+      parser->feed(token);
+    }
+    parser->finish();
+    expect(parser->last_parse_stats().lookups, isEqualTo(1));
+
+    parser->begin();
+    parser->feed("-f");
+    parser->feed("p");
+    parser->finish();
+    expect(parser->last_parse_stats().lookups, isEqualTo(1));
+  });
+
+  test("Every generated default value is timed", [&] {
+    parser->enable_parse_stats();
+    parser->parse({"--name=x"});
+    const auto& stats = parser->last_parse_stats();
+    expect(stats.defaults_evaluated, isEqualTo(2));
+    expect(stats.generator_times.size(), isEqualTo(2));
+    expect(stats.generator_times[0].option, isEqualTo("flag"));
+    expect(stats.generator_times[1].option, isEqualTo("slow"));
+    expect(stats.generator_times[1].time >= std::chrono::milliseconds(2),
+           isTrue);
+    expect(stats.defaults_time >= stats.generator_times[1].time, isTrue);
+  });
+
+  test("Deferred and kept default values are not evaluated", [&] {
+    parser->enable_parse_stats();
+    parser->enable_lazy_defaults();
+    parser->parse({});
+    expect(parser->last_parse_stats().defaults_evaluated, isEqualTo(0));
+
+    Parser kept_parser("");
+    kept_parser.add_argument(ArgumentSpec("name").set_default_value("a"));
+    kept_parser.enable_parse_stats();
+    kept_parser.keep_defaults_across_parses();
+    kept_parser.parse({});
+    expect(kept_parser.last_parse_stats().defaults_evaluated, isEqualTo(1));
+    kept_parser.parse({});
+    expect(kept_parser.last_parse_stats().defaults_evaluated, isEqualTo(0));
+  });
+
+  test("Streaming parses are counted too", [&] {
+    parser->enable_parse_stats();
+    parser->begin();
+    parser->feed("-n");
+    parser->feed("x");
+    parser->finish();
+    const auto& stats = parser->last_parse_stats();
+    expect(stats.tokens, isEqualTo(2));
+    expect(stats.lookups, isEqualTo(1));
+    expect(stats.appeared_options, isEqualTo(1));
+    expect(stats.defaults_evaluated, isEqualTo(2));
+  });
+
+  test("Disabling the collection clears the statistics", [&] {
+    parser->enable_parse_stats();
+    parser->parse({"--name=x"});
+    parser->enable_parse_stats(false);
+    expect(parser->last_parse_stats().tokens, isEqualTo(0));
+    parser->parse({"--name=x"});
+    expect(parser->last_parse_stats().lookups, isEqualTo(0));
+  });
+}
@@ -0,0 +1,239 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <mcga/test.hpp>
+#include <mcga/test_ext/matchers.hpp>
+
+#include "mcga/cli.hpp"
+
+using mcga::cli::ArgumentSpec;
+using mcga::cli::ChoiceArgumentSpec;
+using mcga::cli::FlagSpec;
+using mcga::cli::ListArgumentSpec;
+using mcga::cli::NumericArgument;
+using mcga::cli::NumericArgumentSpec;
+using mcga::cli::Parser;
+using mcga::cli::ParserSchema;
+using mcga::matchers::isEqualTo;
+using mcga::matchers::isFalse;
+using mcga::matchers::isTrue;
+using mcga::matchers::throwsA;
+
+TEST_CASE("Parser schema") {
+  std::unique_ptr<Parser> parser;
+
+  setUp([&] {
+    parser = std::make_unique<Parser>("Help prefix.");
+  });
+
+  tearDown([&] {
+    parser.reset();
+  });
+
+  test("Parsing a schema does not change the parser's options", [&] {
+    auto arg = parser->add_argument(
+        ArgumentSpec("name").set_short_name("n").set_default_value("a"));
+    auto schema = parser->freeze();
+
+    parser->parse({"--name=parser"});
+    auto result = schema->parse({"-n", "schema", "p"});
+
+    expect(result.get(arg), isEqualTo("schema"));
+    expect(result.appeared(arg), isTrue);
+    expect(result.get_if_exists(arg),
+           isEqualTo(std::optional<std::string>("schema")));
+    expect(result.positional_args(),
+           isEqualTo(std::vector<std::string_view>{"p"}));
+    expect(arg->get_value(), isEqualTo("parser"));
+  });
+
+  test("Every kind of option can be read from a result", [&] {
+    auto flag = parser->add_flag(FlagSpec("flag").set_short_name("f"));
+    auto number = parser->add_numeric_argument<int>(
+        NumericArgumentSpec("number").set_default_value("3"));
+    auto choice = parser->add_choice_argument(
+        ChoiceArgumentSpec<int>("choice").add_option("one", 1).add_option(
+            "two", 2).set_default_value("one"));
+    auto list = parser->add_list_argument(
+        ListArgumentSpec<NumericArgument<int>>("list").set_default_value({}));
+    auto schema = parser->freeze();
+
+    auto result = schema->parse({"-f", "--choice=two", "--list=1", "--list=2"});
+    expect(result.get(flag), isTrue);
+    expect(result.get(number), isEqualTo(3));
+    expect(result.appeared(number), isFalse);
+    expect(result.get(choice), isEqualTo(2));
+    expect(result.get(list), isEqualTo(std::vector<int>{1, 2}));
+    expect(result.get_view(choice), isEqualTo(2));
+    expect(result.get_view(list).size(), isEqualTo(2));
+    expect(*result.get_view_if_exists(choice), isEqualTo(2));
+    expect(result.get_view_if_exists(number) == nullptr, isTrue);
+
+    auto defaults = schema->parse({});
+    expect(defaults.get(flag), isFalse);
+    expect(defaults.get(choice), isEqualTo(1));
+    expect(defaults.get(list), isEqualTo(std::vector<int>{}));
+  });
+
+  test("Errors are reported by parse", [&] {
+    parser->add_numeric_argument<int>(NumericArgumentSpec("number"));
+    auto schema = parser->freeze();
+    expect(
+        [&] {
+          (void) schema->parse({"--number=x"});
+        },
+        throwsA<std::invalid_argument>);
+    expect(
+        [&] {
+          (void) schema->parse({});
+        },
+        throwsA<std::invalid_argument>);
+  });
+
+  test("Options registered after freezing are not part of the schema", [&] {
+    parser->add_argument(ArgumentSpec("first").set_default_value("1"));
+    auto help = parser->render_help();
+    auto schema = parser->freeze();
+    parser->add_argument(ArgumentSpec("second"));
+    // "second" has no default value, but is not required by the schema.
+    expect(schema->parse({}).positional_args().empty(), isTrue);
+    expect(schema->render_help(), isEqualTo(help));
+  });
+
+  test("Reading an option that is not part of the schema throws", [&] {
+    auto first =
+        parser->add_argument(ArgumentSpec("first").set_default_value("1"));
+    auto schema = parser->freeze();
+    auto second =
+        parser->add_argument(ArgumentSpec("second").set_default_value("2"));
+    Parser other("");
+    auto foreign = other.add_flag(FlagSpec("flag"));
+    auto result = schema->parse({});
+
+    expect(result.get(first), isEqualTo("1"));
+    expect(
+        [&] {
+          (void) result.get(second);
+        },
+        throwsA<std::logic_error>);
+    expect(
+        [&] {
+          (void) result.get(foreign);
+        },
+        throwsA<std::logic_error>);
+  });
+
+  test("Parsing a batch returns one outcome per command line, in order", [&] {
+    auto count = parser->add_numeric_argument<int>(
+        NumericArgumentSpec("count").set_default_value("0"));
+    std::vector<Parser::ArgList> batch;
+    for (int i = 0; i < 5000; ++i) {
+      batch.push_back({"--count=" + (i % 7 == 0 ? "x" : std::to_string(i)),
+                       "p" + std::to_string(i)});
+    }
+
+    auto outcomes = parser->parse_batch(batch);
+    expect(outcomes.size(), isEqualTo(batch.size()));
+    int num_mismatches = 0;
+    for (int i = 0; i < 5000; ++i) {
+      const auto& outcome = outcomes[i];
+      if (i % 7 == 0) {
+        num_mismatches += outcome.result.has_value() || !outcome.error;
+        continue;
+      }
+      num_mismatches += !outcome.result.has_value() ||
+                        outcome.result->get(count) != i ||
+                        outcome.result->positional_args().front() !=
+                            "p" + std::to_string(i);
+    }
+    expect(num_mismatches, isEqualTo(0));
+    expect(
+        [&] {
+          std::rethrow_exception(outcomes[0].error);
+        },
+        throwsA<std::invalid_argument>);
+  });
+
+  test("Parsing an empty batch", [&] {
+    expect(parser->parse_batch({}).empty(), isTrue);
+  });
+
+  test("Many threads parsing the same schema at once", [&] {
+    auto name = parser->add_argument(
+        ArgumentSpec("name").set_short_name("n").set_default_value("none"));
+    auto count = parser->add_numeric_argument<int>(
+        NumericArgumentSpec("count").set_short_name("c").set_default_value(
+            "0"));
+    auto verbose = parser->add_flag(FlagSpec("verbose").set_short_name("v"));
+    auto tags = parser->add_list_argument(
+        ListArgumentSpec("tag").set_default_value({}));
+    auto schema = parser->freeze();
+
+    constexpr int num_threads = 16;
+    constexpr int num_iterations = 500;
+    std::atomic<int> num_mismatches = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+      threads.emplace_back([&, t] {
+        for (int i = 0; i < num_iterations; ++i) {
+          std::string thread_name = "thread" + std::to_string(t);
+          std::string thread_count = std::to_string(i);
+          std::vector<std::string_view> args{"-n", thread_name, "-c",
+                                             thread_count, "--tag=x",
+                                             "positional"};
+          if (i % 2 == 0) {
+            args.emplace_back("-v");
+          }
+          auto result = schema->parse(std::span(args));
+          if (result.get(name) != thread_name ||
+              result.get(count) != i || result.get(verbose) != (i % 2 == 0) ||
+              result.get(tags) != std::vector<std::string>{"x"} ||
+              result.positional_args().size() != 1) {
+            num_mismatches += 1;
+          }
+        }
+      });
+    }
+    for (std::thread& thread: threads) {
+      thread.join();
+    }
+    expect(num_mismatches.load(), isEqualTo(0));
+  });
+
+  test("Many threads reading the deferred defaults of one result", [&] {
+    std::atomic<int> num_generations = 0;
+    auto name = parser->add_argument(
+        ArgumentSpec("name").set_default_value_generator([&] {
+          num_generations += 1;
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          return std::string("generated");
+        }));
+    auto count = parser->add_numeric_argument<int>(
+        NumericArgumentSpec("count").set_default_value("7"));
+    parser->enable_lazy_defaults();
+    auto schema = parser->freeze();
+    auto result = schema->parse({});
+
+    constexpr int num_threads = 8;
+    std::atomic<int> num_mismatches = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+      threads.emplace_back([&, t] {
+        if (t % 2 == 0) {
+          result.resolve_all();
+        }
+        if (result.get_view(name) != "generated" ||
+            result.get(count) != 7) {
+          num_mismatches += 1;
+        }
+      });
+    }
+    for (std::thread& thread: threads) {
+      thread.join();
+    }
+    expect(num_mismatches.load(), isEqualTo(0));
+    expect(num_generations.load(), isEqualTo(1));
+  });
+}
@@ -1,3 +1,10 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
 #include <mcga/test.hpp>
 #include <mcga/test_ext/matchers.hpp>
 
@@ -124,6 +131,17 @@ TEST_CASE("Parser") {
            expect(arg->get_value_if_exists(),
                   isEqualTo(std::optional{std::string{"v2"}}));
          });
+
+    test("the value can be viewed without copying it", [&] {
+      parser->parse({});
+      expect(arg->get_value_view(), isEqualTo(std::string_view{"a"}));
+      expect(arg->get_value_view_if_exists(), isEqualTo(std::nullopt));
+
+      parser->parse({"--name=value"});
+      expect(arg->get_value_view(), isEqualTo(std::string_view{"value"}));
+      expect(arg->get_value_view_if_exists(),
+             isEqualTo(std::optional{std::string_view{"value"}}));
+    });
   });
 
   group("Multiple arguments", [&] {
@@ -186,6 +204,29 @@ TEST_CASE("Parser") {
            expect(c->appeared(), isTrue);
          });
 
+    test("A single dash is a value for the pending short name", [&] {
+      auto positional = parser->parse({"-c", "-", "-"});
+      expect(c->get_value(), isEqualTo("-"));
+      expect(positional, isEqualTo(std::vector<std::string>{"-"}));
+    });
+
+    test("Everything after a double dash is positional, and a pending short "
+         "name takes its implicit value",
+         [&] {
+           auto positional = parser->parse({"-c", "--", "v", "--arg_a=x"});
+           expect(c->get_value(), isEqualTo("implicit"));
+           expect(a->get_value(), isEqualTo("default"));
+           expect(positional,
+                  isEqualTo(std::vector<std::string>{"v", "--arg_a=x"}));
+         });
+
+    test("Only the first equal sign separates the name from the value", [&] {
+      parser->parse({"-ab=x=y", "--arg_c==z"});
+      expect(a->get_value(), isEqualTo("implicit"));
+      expect(b->get_value(), isEqualTo("x=y"));
+      expect(c->get_value(), isEqualTo("=z"));
+    });
+
     test("Providing values for multiple arguments via a single dash"
          "argument & equal sign for non-implicit value of the last one",
          [&] {
@@ -199,6 +240,758 @@ TEST_CASE("Parser") {
          });
   });
 
+  test("A one-character name can be used in a single dash cluster", [&] {
+    auto x = parser->add_argument(ArgumentSpec("x").set_implicit_value("i"));
+    auto y = parser->add_argument(
+        ArgumentSpec("long").set_short_name("y").set_implicit_value("i"));
+    parser->parse({"-yx=v"});
+    expect(x->get_value(), isEqualTo("v"));
+    expect(y->get_value(), isEqualTo("i"));
+  });
+
+  test("Looking up arguments among thousands of registered ones", [&] {
+    std::vector<Argument> args;
+    for (int i = 0; i < 3000; ++i) {
+      args.push_back(parser->add_argument(
+          ArgumentSpec("arg" + std::to_string(i)).set_default_value("d")));
+    }
+    parser->parse({"--arg0=a", "--arg1337=b", "--arg2999=c", "--arg3000=x"});
+    expect(args[0]->get_value(), isEqualTo("a"));
+    expect(args[1337]->get_value(), isEqualTo("b"));
+    expect(args[2999]->get_value(), isEqualTo("c"));
+    expect(args[1]->get_value(), isEqualTo("d"));
+    expect(args[1]->appeared(), isFalse);
+
+    // registering after a parse makes the next parse see the new argument.
+    auto late = parser->add_argument(ArgumentSpec("late"));
+    parser->parse({"--late=value"});
+    expect(late->get_value(), isEqualTo("value"));
+  });
+
+  group("Incremental re-parse", [&] {
+    int num_default_calls = 0;
+    Argument a;
+    Argument b;
+    mcga::cli::ListArgument<> list;
+
+    setUp([&] {
+      num_default_calls = 0;
+      a = parser->add_argument(ArgumentSpec("arg_a")
+                                   .set_short_name("a")
+                                   .set_default_value_generator([&] {
+                                     num_default_calls += 1;
+                                     return "default";
+                                   })
+                                   .set_implicit_value("implicit"));
+      b = parser->add_argument(ArgumentSpec("arg_b")
+                                   .set_short_name("b")
+                                   .set_default_value("default")
+                                   .set_implicit_value("implicit"));
+      list = parser->add_list_argument(
+          mcga::cli::ListArgumentSpec("list").set_default_value({"d"}));
+    });
+
+    test("First call is a full parse", [&] {
+      auto positional = parser->reparse_delta({"-b", "x", "p"});
+      expect(positional, isEqualTo(std::vector<std::string>{"p"}));
+      expect(a->get_value(), isEqualTo("default"));
+      expect(b->get_value(), isEqualTo("x"));
+      expect(list->get_value(), isEqualTo(std::vector<std::string>{"d"}));
+      expect(num_default_calls, isEqualTo(1));
+    });
+
+    test("Unaffected arguments do not generate their defaults again", [&] {
+      parser->reparse_delta({"-b", "x"});
+      parser->reparse_delta({"-b", "y"});
+      parser->reparse_delta({"--list=1", "-b", "y", "--list=2"});
+      expect(num_default_calls, isEqualTo(1));
+      expect(a->get_value(), isEqualTo("default"));
+      expect(b->get_value(), isEqualTo("y"));
+      expect(list->get_value(), isEqualTo(std::vector<std::string>{"1", "2"}));
+    });
+
+    test("Removed arguments go back to their default values", [&] {
+      parser->reparse_delta({"-ab", "x", "--list=1"});
+      expect(a->get_value(), isEqualTo("implicit"));
+      expect(a->appeared(), isTrue);
+      parser->reparse_delta({"--list=1"});
+      expect(a->get_value(), isEqualTo("default"));
+      expect(a->appeared(), isFalse);
+      expect(b->get_value(), isEqualTo("default"));
+      expect(b->appeared(), isFalse);
+      expect(list->get_value(), isEqualTo(std::vector<std::string>{"1"}));
+    });
+
+    test("A parse in between makes the next call a full parse", [&] {
+      parser->reparse_delta({"-b", "x"});
+      parser->parse({"-b", "y"});
+      parser->reparse_delta({"-b", "x"});
+      expect(b->get_value(), isEqualTo("x"));
+      expect(num_default_calls, isEqualTo(3));
+    });
+
+    test("Errors are reported, and the following call starts over", [&] {
+      parser->reparse_delta({"-b", "x"});
+      auto c = parser->add_argument(ArgumentSpec("arg_c"));
+      expect(
+          [&] {
+            parser->reparse_delta({"-b", "x"});
+          },
+          throwsA<std::invalid_argument>);
+      parser->reparse_delta({"-b", "x", "--arg_c=c"});
+      expect(c->get_value(), isEqualTo("c"));
+      expect(b->get_value(), isEqualTo("x"));
+    });
+
+    test("Errors are the ones of the first invalid argument", [&] {
+      parser->add_numeric_argument<int>(
+          mcga::cli::NumericArgumentSpec("first"));
+      parser->add_numeric_argument<int>(
+          mcga::cli::NumericArgumentSpec("second"));
+      auto error_of = [&](auto parse) {
+        std::string message;
+        try {
+          parse({"--second=x", "--first=y"});
+        } catch (const std::invalid_argument& error) {
+          message = error.what();
+        }
+        return message;
+      };
+      std::string expected = error_of([&](const Parser::ArgList& args) {
+        parser->parse(args);
+      });
+      expect(expected.find("`x`") != std::string::npos, isTrue);
+      auto reparse = [&](const Parser::ArgList& args) {
+        parser->reparse_delta(args);
+      };
+      expect(error_of(reparse), isEqualTo(expected));
+      parser->reparse_delta({"--first=1", "--second=2"});
+      expect(error_of(reparse), isEqualTo(expected));
+    });
+  });
+
+  group("Parsing without copying arguments", [&] {
+    Argument arg;
+
+    setUp([&] {
+      arg = parser->add_argument(ArgumentSpec("name")
+                                     .set_short_name("n")
+                                     .set_default_value("a")
+                                     .set_implicit_value("b"));
+    });
+
+    test("string_view span, positional arguments are views into the input",
+         [&] {
+           std::string storage[] = {"p1", "--name=v", "p2"};
+           std::vector<std::string_view> args(std::begin(storage),
+                                              std::end(storage));
+           auto positional = parser->parse(std::span(args));
+           expect(positional.size(), isEqualTo(2u));
+           expect(positional[0].data() == storage[0].data(), isTrue);
+           expect(positional[1].data() == storage[2].data(), isTrue);
+           expect(arg->get_value(), isEqualTo("v"));
+         });
+
+    test("argv-style span", [&] {
+      const char* argv[] = {"program", "-n", "value", "--", "-n"};
+      auto positional = parser->parse(std::span<const char* const>(argv));
+      expect(positional.size(), isEqualTo(2u));
+      expect(positional[0].data() == argv[0], isTrue);
+      expect(positional[1].data() == argv[4], isTrue);
+      expect(arg->get_value(), isEqualTo("value"));
+    });
+
+    test("argc & argv", [&] {
+      char program[] = "program";
+      char name[] = "--name=value";
+      char* argv[] = {program, name};
+      auto positional = parser->parse(2, argv);
+      expect(positional, isEqualTo(std::vector<std::string>{"program"}));
+      expect(arg->get_value(), isEqualTo("value"));
+    });
+  });
+
+  group("Response files", [&] {
+    Argument arg;
+    std::vector<std::filesystem::path> files;
+
+    auto write_file = [&](const std::string& name,
+                          const std::string& contents) {
+      auto path = std::filesystem::temp_directory_path() /
+                  ("mcga_cli_test_" + name);
+      std::ofstream(path, std::ios::binary) << contents;
+      files.push_back(path);
+      return "@" + path.string();
+    };
+
+    setUp([&] {
+      arg = parser->add_argument(ArgumentSpec("name")
+                                     .set_short_name("n")
+                                     .set_default_value("a")
+                                     .set_implicit_value("b"));
+      parser->enable_response_files();
+    });
+
+    tearDown([&] {
+      for (const auto& path: files) {
+        std::filesystem::remove(path);
+      }
+      files.clear();
+    });
+
+    test("Arguments of a response file are expanded in place", [&] {
+      auto file = write_file("simple", "p2\n  -n\tvalue\n\np3\n");
+      auto positional = parser->parse({"p1", file, "p4"});
+      expect(positional,
+             isEqualTo(std::vector<std::string>{"p1", "p2", "p3", "p4"}));
+      expect(arg->get_value(), isEqualTo("value"));
+    });
+
+    test("Quotes and escapes", [&] {
+      auto file = write_file(
+          "quotes", "'a b' \"c \\\" d\" e\\ f 'g\\h' \"\" x\"y\"'z'");
+      auto positional = parser->parse({file});
+      expect(positional, isEqualTo(std::vector<std::string>{
+                             "a b", "c \" d", "e f", "g\\h", "", "xyz"}));
+    });
+
+    test("Positional views into a response file stay valid", [&] {
+      auto file = write_file("views", "-n 'quoted value' positional");
+      std::string_view args[] = {file};
+      auto positional = parser->parse(std::span<const std::string_view>(args));
+      expect(positional.size(), isEqualTo(1u));
+      expect(positional[0], isEqualTo("positional"));
+      expect(arg->get_value(), isEqualTo("quoted value"));
+    });
+
+    test("A short name at the end of a response file takes the next value",
+         [&] {
+           auto file = write_file("pending", "-n");
+           parser->parse({file, "value"});
+           expect(arg->get_value(), isEqualTo("value"));
+         });
+
+    test("Nested response files", [&] {
+      auto inner = write_file("inner", "--name=inner p2");
+      auto outer = write_file("outer", "p1 " + inner + " p3");
+      auto positional = parser->parse({outer});
+      expect(positional,
+             isEqualTo(std::vector<std::string>{"p1", "p2", "p3"}));
+      expect(arg->get_value(), isEqualTo("inner"));
+    });
+
+    test("A response file including itself throws", [&] {
+      auto path = std::filesystem::temp_directory_path() /
+                  "mcga_cli_test_cycle_b";
+      auto first = write_file("cycle_a", "x @" + path.string());
+      write_file("cycle_b", "y " + first);
+      expect(
+          [&] {
+            parser->parse({first});
+          },
+          throwsA<std::invalid_argument>);
+    });
+
+    test("Missing files and a lone @ are kept as they are", [&] {
+      auto positional =
+          parser->parse({"@", "@/this/file/does/not/exist", "@@"});
+      expect(positional,
+             isEqualTo(std::vector<std::string>{
+                 "@", "@/this/file/does/not/exist", "@@"}));
+    });
+
+    test("Response files are not expanded unless enabled", [&] {
+      Parser other("Other parser.");
+      auto file = write_file("disabled", "p1 p2");
+      expect(other.parse({file}), isEqualTo(std::vector<std::string>{file}));
+    });
+
+    test("Frozen schemas and incremental re-parse expand response files",
+         [&] {
+           auto file = write_file("schema", "--name=from_file p1");
+           auto result = parser->freeze()->parse({file});
+           expect(result.get(arg), isEqualTo("from_file"));
+           expect(result.positional_args(),
+                  isEqualTo(std::vector<std::string_view>{"p1"}));
+
+           parser->reparse_delta({file});
+           expect(arg->get_value(), isEqualTo("from_file"));
+           parser->reparse_delta({file, "-n", "cli"});
+           expect(arg->get_value(), isEqualTo("cli"));
+         });
+  });
+
+  group("Environment variables", [&] {
+    Argument arg;
+    mcga::cli::NumericArgument<int> number;
+    mcga::cli::Flag flag;
+
+    setUp([&] {
+      setenv("MCGA_CLI_TEST_NAME", "from_env", 1);
+      setenv("MCGA_CLI_TEST_NUMBER", "17", 1);
+      unsetenv("MCGA_CLI_TEST_FLAG");
+      arg = parser->add_argument(ArgumentSpec("name")
+                                     .set_short_name("n")
+                                     .set_env_var("MCGA_CLI_TEST_NAME")
+                                     .set_default_value("default"));
+      number = parser->add_numeric_argument<int>(
+          mcga::cli::NumericArgumentSpec("number")
+              .set_env_var("MCGA_CLI_TEST_NUMBER")
+              .set_default_value("0"));
+      flag = parser->add_flag(
+          mcga::cli::FlagSpec("flag").set_env_var("MCGA_CLI_TEST_FLAG"));
+    });
+
+    tearDown([&] {
+      unsetenv("MCGA_CLI_TEST_NAME");
+      unsetenv("MCGA_CLI_TEST_NUMBER");
+      unsetenv("MCGA_CLI_TEST_FLAG");
+    });
+
+    test("Environment is used when the option is not in the arguments", [&] {
+      parser->parse({});
+      expect(arg->get_value(), isEqualTo("from_env"));
+      expect(arg->appeared(), isTrue);
+      expect(number->get_value(), isEqualTo(17));
+      expect(flag->get_value(), isFalse);
+      expect(flag->appeared(), isFalse);
+    });
+
+    test("Arguments take precedence over the environment", [&] {
+      parser->parse({"-n", "cli", "--number=3"});
+      expect(arg->get_value(), isEqualTo("cli"));
+      expect(number->get_value(), isEqualTo(3));
+    });
+
+    test("Environment values are validated like arguments", [&] {
+      setenv("MCGA_CLI_TEST_FLAG", "maybe", 1);
+      expect(
+          [&] {
+            parser->parse({});
+          },
+          throwsA<std::invalid_argument>);
+      setenv("MCGA_CLI_TEST_FLAG", "enabled", 1);
+      parser->parse({});
+      expect(flag->get_value(), isTrue);
+    });
+
+    test("Two arguments reading the same variable throws", [&] {
+      expect(
+          [&] {
+            parser->add_argument(
+                ArgumentSpec("other").set_env_var("MCGA_CLI_TEST_NAME"));
+          },
+          throwsA<std::logic_error>);
+    });
+
+    test("Frozen schemas read the environment", [&] {
+      auto schema = parser->freeze();
+      setenv("MCGA_CLI_TEST_NUMBER", "23", 1);
+      auto result = schema->parse({});
+      expect(result.get(number), isEqualTo(23));
+      expect(result.get(arg), isEqualTo("from_env"));
+    });
+
+    test("Incremental re-parse follows changes of the environment", [&] {
+      parser->reparse_delta({});
+      expect(number->get_value(), isEqualTo(17));
+      setenv("MCGA_CLI_TEST_NUMBER", "18", 1);
+      parser->reparse_delta({"-n", "cli"});
+      expect(number->get_value(), isEqualTo(18));
+      expect(arg->get_value(), isEqualTo("cli"));
+      unsetenv("MCGA_CLI_TEST_NUMBER");
+      unsetenv("MCGA_CLI_TEST_NAME");
+      parser->reparse_delta({});
+      expect(number->get_value(), isEqualTo(0));
+      expect(arg->get_value(), isEqualTo("default"));
+    });
+  });
+
+  group("Config files", [&] {
+    Argument arg;
+    mcga::cli::NumericArgument<int> number;
+    mcga::cli::Flag flag;
+    mcga::cli::ListArgument<> list;
+    std::vector<std::filesystem::path> files;
+
+    auto write_file = [&](const std::string& name,
+                          const std::string& contents) {
+      auto path = std::filesystem::temp_directory_path() /
+                  ("mcga_cli_config_test_" + name);
+      std::ofstream(path, std::ios::binary) << contents;
+      files.push_back(path);
+      return path.string();
+    };
+
+    setUp([&] {
+      arg = parser->add_argument(ArgumentSpec("name")
+                                     .set_short_name("n")
+                                     .set_env_var("MCGA_CLI_CONFIG_TEST_NAME")
+                                     .set_default_value("default"));
+      number = parser->add_numeric_argument<int>(
+          mcga::cli::NumericArgumentSpec("number").set_default_value("0"));
+      flag = parser->add_flag(mcga::cli::FlagSpec("flag"));
+      list = parser->add_list_argument(
+          mcga::cli::ListArgumentSpec("list").set_default_value({}));
+    });
+
+    tearDown([&] {
+      unsetenv("MCGA_CLI_CONFIG_TEST_NAME");
+      for (const auto& path: files) {
+        std::filesystem::remove(path);
+      }
+      files.clear();
+    });
+
+    test("Values are read from the config file", [&] {
+      parser->load_config_file(
+          write_file("simple",
+                     "# comment\n"
+                     "  name =  ' spaced value '\n"
+                     "\n"
+                     "; another comment\n"
+                     "number=42\n"
+                     "flag\n"
+                     "list = a\n"
+                     "list = \"b\""));
+      parser->parse({});
+      expect(arg->get_value(), isEqualTo(" spaced value "));
+      expect(arg->appeared(), isTrue);
+      expect(number->get_value(), isEqualTo(42));
+      expect(flag->get_value(), isTrue);
+      expect(list->get_value(), isEqualTo(std::vector<std::string>{"a", "b"}));
+    });
+
+    test("Arguments and environment take precedence over config files", [&] {
+      parser->load_config_file(
+          write_file("precedence", "name = config\nnumber = 1\nlist = c"));
+      setenv("MCGA_CLI_CONFIG_TEST_NAME", "env", 1);
+      parser->parse({"--number=2", "--list=d"});
+      expect(arg->get_value(), isEqualTo("env"));
+      expect(number->get_value(), isEqualTo(2));
+      expect(list->get_value(), isEqualTo(std::vector<std::string>{"d"}));
+    });
+
+    test("Later config files take precedence", [&] {
+      parser->load_config_file(write_file("first", "number = 1\nlist = a"));
+      parser->load_config_file(write_file("second", "number = 2\nlist = b"));
+      parser->parse({});
+      expect(number->get_value(), isEqualTo(2));
+      expect(list->get_value(), isEqualTo(std::vector<std::string>{"a", "b"}));
+    });
+
+    test("Config values are validated like arguments", [&] {
+      parser->load_config_file(write_file("invalid", "number = many"));
+      expect(
+          [&] {
+            parser->parse({});
+          },
+          throwsA<std::invalid_argument>);
+    });
+
+    test("Include directives", [&] {
+      write_file("included", "number = 7");
+      parser->load_config_file(write_file(
+          "including", "name = outer\ninclude mcga_cli_config_test_included"));
+      parser->parse({});
+      expect(arg->get_value(), isEqualTo("outer"));
+      expect(number->get_value(), isEqualTo(7));
+    });
+
+    test("A config file including itself throws", [&] {
+      write_file("cycle_b", "include mcga_cli_config_test_cycle_a");
+      auto path =
+          write_file("cycle_a", "include mcga_cli_config_test_cycle_b");
+      expect(
+          [&] {
+            parser->load_config_file(path);
+          },
+          throwsA<std::invalid_argument>);
+    });
+
+    test("Unknown names throw, and leave the loaded values unchanged", [&] {
+      auto path = write_file("unknown", "number = 3\nunknown = 1");
+      expect(
+          [&] {
+            parser->load_config_file(path);
+          },
+          throwsA<std::invalid_argument>);
+      parser->parse({});
+      expect(number->get_value(), isEqualTo(0));
+    });
+
+    test("Missing config file throws", [&] {
+      expect(
+          [&] {
+            parser->load_config_file("/this/file/does/not/exist");
+          },
+          throwsA<std::invalid_argument>);
+    });
+
+    test("Frozen schemas and incremental re-parse use config files", [&] {
+      parser->load_config_file(write_file("schema", "number = 5"));
+      auto result = parser->freeze()->parse({});
+      expect(result.get(number), isEqualTo(5));
+
+      parser->reparse_delta({"--number=6"});
+      expect(number->get_value(), isEqualTo(6));
+      parser->reparse_delta({});
+      expect(number->get_value(), isEqualTo(5));
+    });
+  });
+
+  group("Lazy default values", [&] {
+    Argument arg;
+    mcga::cli::NumericArgument<int> number;
+    mcga::cli::ListArgument<> list;
+    int num_generated = 0;
+    std::string number_default = "1";
+
+    setUp([&] {
+      num_generated = 0;
+      number_default = "1";
+      arg = parser->add_argument(
+          ArgumentSpec("name").set_default_value_generator([&] {
+            num_generated += 1;
+            return std::string("generated");
+          }));
+      number = parser->add_numeric_argument<int>(
+          mcga::cli::NumericArgumentSpec("number")
+              .set_default_value_generator([&] {
+                return number_default;
+              }));
+      list = parser->add_list_argument(
+          mcga::cli::ListArgumentSpec("list").set_default_value_generator(
+              [&] {
+                num_generated += 1;
+                return std::vector<std::string>{"a", "b"};
+              }));
+    });
+
+    test("Defaults are generated when they are first read", [&] {
+      parser->enable_lazy_defaults();
+      parser->parse({});
+      expect(num_generated, isEqualTo(0));
+      expect(arg->get_value(), isEqualTo("generated"));
+      expect(arg->get_value(), isEqualTo("generated"));
+      expect(arg->appeared(), isFalse);
+      expect(num_generated, isEqualTo(1));
+      parser->parse({});
+      expect(arg->get_value(), isEqualTo("generated"));
+      expect(num_generated, isEqualTo(2));
+    });
+
+    test("Errors of generators are raised on read, or by resolve_all", [&] {
+      parser->enable_lazy_defaults();
+      number_default = "not a number";
+      parser->parse({});
+      expect(
+          [&] {
+            parser->resolve_all();
+          },
+          throwsA<std::invalid_argument>);
+      expect(
+          [&] {
+            (void) number->get_value();
+          },
+          throwsA<std::invalid_argument>);
+      number_default = "3";
+      parser->resolve_all();
+      expect(number->get_value(), isEqualTo(3));
+    });
+
+    test("Missing default values are still reported by parse", [&] {
+      parser->enable_lazy_defaults();
+      parser->add_argument(ArgumentSpec("required"));
+      expect(
+          [&] {
+            parser->parse({});
+          },
+          throwsA<std::invalid_argument>);
+    });
+
+    test("Defaults kept across parses are generated once", [&] {
+      parser->enable_lazy_defaults();
+      parser->keep_defaults_across_parses();
+      parser->parse({});
+      expect(arg->get_value(), isEqualTo("generated"));
+      expect(list->get_value(),
+             isEqualTo(std::vector<std::string>{"a", "b"}));
+      parser->parse({});
+      expect(arg->get_value(), isEqualTo("generated"));
+      expect(list->get_value(),
+             isEqualTo(std::vector<std::string>{"a", "b"}));
+      expect(num_generated, isEqualTo(2));
+
+      parser->parse({"--name=x", "--list=c"});
+      expect(arg->get_value(), isEqualTo("x"));
+      expect(list->get_value(), isEqualTo(std::vector<std::string>{"c"}));
+      parser->parse({});
+      expect(arg->get_value(), isEqualTo("generated"));
+      expect(num_generated, isEqualTo(3));
+    });
+
+    test("Kept defaults without lazy generation", [&] {
+      parser->keep_defaults_across_parses();
+      parser->parse({});
+      parser->parse({});
+      expect(num_generated, isEqualTo(2));
+      expect(list->get_value(),
+             isEqualTo(std::vector<std::string>{"a", "b"}));
+    });
+
+    test("Frozen schemas generate defaults lazily", [&] {
+      parser->enable_lazy_defaults();
+      auto result = parser->freeze()->parse({});
+      expect(num_generated, isEqualTo(0));
+      result.resolve_all();
+      expect(num_generated, isEqualTo(2));
+      expect(result.get(arg), isEqualTo("generated"));
+      expect(num_generated, isEqualTo(2));
+    });
+  });
+
+  group("Concurrent default values", [&] {
+    std::vector<std::thread> threads;
+    std::atomic<int> num_running{0};
+
+    // waits (for a bounded time) until `count` generators run at once.
+    auto wait_for_generators = [&](int count) {
+      num_running += 1;
+      auto deadline =
+          std::chrono::steady_clock::now() + std::chrono::seconds(10);
+      while (num_running < count &&
+             std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+      }
+      return num_running >= count ? "concurrent" : "sequential";
+    };
+
+    auto thread_per_task = [&](std::function<void()> task) {
+      threads.emplace_back(std::move(task));
+    };
+
+    setUp([&] {
+      num_running = 0;
+    });
+
+    tearDown([&] {
+      for (auto& thread: threads) {
+        thread.join();
+      }
+      threads.clear();
+    });
+
+    test("Independent generators run concurrently", [&] {
+      parser->enable_concurrent_defaults(thread_per_task);
+      std::vector<Argument> args;
+      for (int i = 0; i < 3; ++i) {
+        args.push_back(parser->add_argument(
+            ArgumentSpec("arg" + std::to_string(i))
+                .set_default_value_generator([&] {
+                  return std::string(wait_for_generators(3));
+                })
+                .set_independent_default_value()));
+      }
+      auto dependent = parser->add_argument(
+          ArgumentSpec("dependent").set_default_value_generator([&] {
+            return std::to_string(num_running.load());
+          }));
+      parser->parse({});
+      expect(threads.size(), isEqualTo(3u));
+      for (const auto& arg: args) {
+        expect(arg->get_value(), isEqualTo("concurrent"));
+      }
+      // the other generators run after the independent ones.
+      expect(dependent->get_value(), isEqualTo("3"));
+    });
+
+    test("The error of the first option is raised", [&] {
+      parser->enable_concurrent_defaults(thread_per_task);
+      parser->add_argument(ArgumentSpec("ok")
+                               .set_default_value("ok")
+                               .set_independent_default_value());
+      for (std::string name: {"first", "second", "third"}) {
+        parser->add_argument(
+            ArgumentSpec(name)
+                .set_default_value_generator([name]() -> std::string {
+                  throw std::runtime_error(name);
+                })
+                .set_independent_default_value(name != "first"));
+      }
+      std::string message;
+      try {
+        parser->parse({});
+      } catch (const std::runtime_error& error) {
+        message = error.what();
+      }
+      expect(message, isEqualTo("first"));
+      try {
+        parser->parse({"--first=x"});
+      } catch (const std::runtime_error& error) {
+        message = error.what();
+      }
+      expect(message, isEqualTo("second"));
+    });
+
+    test("An executor error is raised after the submitted tasks", [&] {
+      std::atomic<int> num_generated{0};
+      parser->enable_concurrent_defaults([&](std::function<void()> task) {
+        if (threads.size() == 2) {
+          throw std::runtime_error("executor is full");
+        }
+        threads.emplace_back(std::move(task));
+      });
+      std::vector<Argument> args;
+      for (int i = 0; i < 4; ++i) {
+        args.push_back(parser->add_argument(
+            ArgumentSpec("arg" + std::to_string(i))
+                .set_default_value_generator([&] {
+                  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                  num_generated += 1;
+                  return std::string("generated");
+                })
+                .set_independent_default_value()));
+      }
+      std::string message;
+      try {
+        parser->parse({});
+      } catch (const std::runtime_error& error) {
+        message = error.what();
+      }
+      expect(message, isEqualTo("executor is full"));
+      expect(num_generated.load(), isEqualTo(4));
+    });
+
+    test("Internal thread pool, lazy defaults and frozen schemas", [&] {
+      parser->enable_concurrent_defaults();
+      std::vector<mcga::cli::NumericArgument<int>> numbers;
+      for (int i = 0; i < 8; ++i) {
+        numbers.push_back(parser->add_numeric_argument<int>(
+            mcga::cli::NumericArgumentSpec("n" + std::to_string(i))
+                .set_default_value_generator([i] {
+                  return std::to_string(i * i);
+                })
+                .set_independent_default_value()));
+      }
+      parser->parse({});
+      for (int i = 0; i < 8; ++i) {
+        expect(numbers[i]->get_value(), isEqualTo(i * i));
+      }
+
+      auto result = parser->freeze()->parse({"--n3=0"});
+      expect(result.get(numbers[3]), isEqualTo(0));
+      expect(result.get(numbers[7]), isEqualTo(49));
+
+      parser->enable_lazy_defaults();
+      parser->parse({});
+      parser->resolve_all();
+      for (int i = 0; i < 8; ++i) {
+        expect(numbers[i]->get_value(), isEqualTo(i * i));
+      }
+    });
+  });
+
   group("Invalid argument names", [&] {
     test("Registering an argument with the same name as an existing one "
          "throws",
@@ -277,4 +1070,92 @@ TEST_CASE("Parser") {
           throwsA<std::invalid_argument>);
     });
   });
+
+  group("Streaming", [&] {
+    Argument arg;
+    Argument other;
+    std::vector<std::string> resolved;
+
+    setUp([&] {
+      resolved.clear();
+      arg = parser->add_argument(ArgumentSpec("name")
+                                     .set_short_name("n")
+                                     .set_default_value("a")
+                                     .set_implicit_value("b"));
+      other = parser->add_argument(
+          ArgumentSpec("other").set_short_name("o").set_default_value("c"));
+      parser->on_value(arg, [&](std::string_view value) {
+        resolved.push_back("name=" + std::string(value));
+      });
+      parser->on_value(other, [&](std::string_view value) {
+        resolved.push_back("other=" + std::string(value));
+      });
+    });
+
+    test("Feeding arguments one at a time parses them as parse does", [&] {
+      parser->begin();
+      for (const char* token: {"p1", "--name=x", "-o", "y", "p2"}) {
+        // the parser does not keep views into the fed arguments.
+        std::string arg_copy = token;
+        parser->feed(arg_copy);
+      }
+      auto positional = parser->finish();
+
+      expect(positional, isEqualTo(std::vector<std::string>{"p1", "p2"}));
+      expect(arg->get_value(), isEqualTo("x"));
+      expect(other->get_value(), isEqualTo("y"));
+    });
+
+    test("Callbacks are called as soon as the options are resolved", [&] {
+      parser->begin();
+      parser->feed("--name=x");
+      expect(resolved, isEqualTo(std::vector<std::string>{"name=x"}));
+
+      // the pending short name waits for the next argument.
+      parser->feed("-o");
+      expect(resolved.size(), isEqualTo(1));
+      parser->feed("y");
+      expect(resolved,
+             isEqualTo(std::vector<std::string>{"name=x", "other=y"}));
+
+      parser->finish();
+      expect(resolved.size(), isEqualTo(2));
+    });
+
+    test("Finishing applies the pending short name and the defaults", [&] {
+      parser->begin();
+      parser->feed("-n");
+      expect(resolved.empty(), isTrue);
+
+      parser->finish();
+      expect(resolved,
+             isEqualTo(std::vector<std::string>{"name=b", "other=c"}));
+    });
+
+    test("Feeding without a streaming parse throws", [&] {
+      expect(
+          [&] {
+            parser->feed("--name=x");
+          },
+          throwsA<std::logic_error>);
+
+      parser->begin();
+      parser->parse({});
+      expect(
+          [&] {
+            parser->finish();
+          },
+          throwsA<std::logic_error>);
+    });
+
+    test("Registering a callback for another parser's option throws", [&] {
+      Parser other_parser("");
+      auto foreign = other_parser.add_argument(ArgumentSpec("foreign"));
+      expect(
+          [&] {
+            parser->on_value(foreign, [](std::string_view) {});
+          },
+          throwsA<std::logic_error>);
+    });
+  });
 }
@@ -0,0 +1,176 @@
+#include <mcga/test.hpp>
+#include <mcga/test_ext/matchers.hpp>
+
+#include "mcga/cli.hpp"
+
+using mcga::cli::StaticArgument;
+using mcga::cli::StaticChoiceArgument;
+using mcga::cli::StaticFlag;
+using mcga::cli::StaticNumericArgument;
+using mcga::cli::StaticParser;
+using mcga::matchers::isEqualTo;
+using mcga::matchers::isFalse;
+using mcga::matchers::isTrue;
+using mcga::matchers::throwsA;
+
+namespace {
+
+struct Verbose: StaticFlag {
+  static constexpr std::string_view name = "verbose";
+  static constexpr char short_name = 'v';
+};
+
+struct Jobs: StaticNumericArgument<int> {
+  static constexpr std::string_view name = "jobs";
+  static constexpr char short_name = 'j';
+  static constexpr std::string_view default_value = "1";
+  static constexpr std::string_view implicit_value = "4";
+};
+
+struct Output: StaticArgument {
+  static constexpr std::string_view name = "output";
+  static constexpr char short_name = 'o';
+  static constexpr std::string_view default_value = "a.out";
+};
+
+enum class Mode { fast, safe };
+
+struct ModeArg: StaticChoiceArgument<ModeArg, Mode> {
+  static constexpr std::string_view name = "mode";
+  static constexpr std::string_view default_value = "safe";
+  static constexpr std::pair<std::string_view, Mode> options[] = {
+      {"fast", Mode::fast}, {"safe", Mode::safe}};
+};
+
+enum class Level { low, medium, high };
+
+struct LevelArg: StaticChoiceArgument<LevelArg, Level> {
+  static constexpr std::string_view name = "level";
+  static constexpr std::string_view default_value = "medium";
+  static constexpr std::pair<std::string_view, Level> options[] = {
+      {"medium", Level::medium}, {"low", Level::low}, {"high", Level::high}};
+};
+
+static_assert(*mcga::cli::internal::find_choice(
+                  mcga::cli::internal::sort_choices(LevelArg::options),
+                  "low") == Level::low);
+
+struct Required: StaticArgument {
+  static constexpr std::string_view name = "required";
+};
+
+using TestParser = StaticParser<Verbose, Jobs, Output, ModeArg>;
+
+using TestIndex = mcga::cli::internal::StaticOptionIndex<3>;
+
+static_assert(TestIndex({{{"verbose", 0}, {"v", 0}, {"jobs", 1}}}).found_seed);
+
+} // namespace
+
+TEST_CASE("Static parser") {
+  TestParser::Values values;
+
+  test("No values provided leads to default values", [&] {
+    auto positional = TestParser::parse({}, values);
+    expect(positional.empty(), isTrue);
+    expect(values.get<Verbose>(), isFalse);
+    expect(values.get<Jobs>(), isEqualTo(1));
+    expect(values.get<Output>(), isEqualTo(std::string_view("a.out")));
+    expect(values.get<ModeArg>() == Mode::safe, isTrue);
+    expect(values.appeared<Jobs>(), isFalse);
+  });
+
+  test("Long names, with and without values", [&] {
+    TestParser::parse({"--verbose", "--jobs", "--output=out", "--mode=fast"},
+                      values);
+    expect(values.get<Verbose>(), isTrue);
+    expect(values.get<Jobs>(), isEqualTo(4));
+    expect(values.get<Output>(), isEqualTo(std::string_view("out")));
+    expect(values.get<ModeArg>() == Mode::fast, isTrue);
+    expect(values.appeared<Jobs>(), isTrue);
+  });
+
+  test("Single dash clusters follow the same rules as Parser", [&] {
+    auto positional = TestParser::parse({"-vj", "8", "p1", "-o=x"}, values);
+    expect(values.get<Verbose>(), isTrue);
+    expect(values.get<Jobs>(), isEqualTo(8));
+    expect(values.get<Output>(), isEqualTo(std::string_view("x")));
+    expect(positional, isEqualTo(std::vector<std::string_view>{"p1"}));
+
+    positional = TestParser::parse({"-jv", "p1", "--", "-o"}, values);
+    expect(values.get<Jobs>(), isEqualTo(4));
+    expect(values.get<Verbose>(), isTrue);
+    expect(positional, isEqualTo(std::vector<std::string_view>{"p1", "-o"}));
+  });
+
+  test("Values are views into the arguments", [&] {
+    const char* argv[] = {"program", "--output=file.txt"};
+    auto positional =
+        TestParser::parse(std::span<const char* const>(argv), values);
+    expect(positional[0].data() == argv[0], isTrue);
+    expect(values.get<Output>().data() == argv[1] + 9, isTrue);
+  });
+
+  test("Invalid values throw", [&] {
+    expect(
+        [&] {
+          TestParser::parse({"--jobs=many"}, values);
+        },
+        throwsA<std::invalid_argument>);
+    expect(
+        [&] {
+          TestParser::parse({"--mode=slow"}, values);
+        },
+        throwsA<std::invalid_argument>);
+    expect(
+        [&] {
+          TestParser::parse({"--verbose=maybe"}, values);
+        },
+        throwsA<std::invalid_argument>);
+  });
+
+  test("Flag values are matched ignoring case, as for Parser", [&] {
+    TestParser::parse({"--verbose=Enabled"}, values);
+    expect(values.get<Verbose>(), isTrue);
+    TestParser::parse({"--verbose=FALSE"}, values);
+    expect(values.get<Verbose>(), isFalse);
+  });
+
+  test("Missing default and implicit values throw", [&] {
+    StaticParser<Required>::Values required_values;
+    expect(
+        [&] {
+          StaticParser<Required>::parse({}, required_values);
+        },
+        throwsA<std::invalid_argument>);
+    expect(
+        [&] {
+          StaticParser<Required>::parse({"--required"}, required_values);
+        },
+        throwsA<std::invalid_argument>);
+    StaticParser<Required>::parse({"--required=x"}, required_values);
+    expect(required_values.get<Required>(), isEqualTo(std::string_view("x")));
+  });
+
+  test("Choices do not need to be declared in order", [&] {
+    StaticParser<LevelArg>::Values level_values;
+    StaticParser<LevelArg>::parse({}, level_values);
+    expect(level_values.get<LevelArg>() == Level::medium, isTrue);
+    for (auto [arg, level]: {std::pair{"--level=high", Level::high},
+                             std::pair{"--level=low", Level::low}}) {
+      StaticParser<LevelArg>::parse({arg}, level_values);
+      expect(level_values.get<LevelArg>() == level, isTrue);
+    }
+    expect(
+        [&] {
+          StaticParser<LevelArg>::parse({"--level=lo"}, level_values);
+        },
+        throwsA<std::invalid_argument>);
+  });
+
+  test("An index without a perfect hash reports it", [&] {
+    // the same key twice never gets a slot of its own.
+    TestIndex index({{{"jobs", 0}, {"jobs", 1}, {"v", 0}}});
+    expect(index.found_seed, isFalse);
+  });
+}
@@ -0,0 +1,51 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <mcga/test.hpp>
+#include <mcga/test_ext/matchers.hpp>
+
+#include "mcga/cli/thread_pool.hpp"
+
+using mcga::cli::internal::ThreadPool;
+using mcga::matchers::isEqualTo;
+
+TEST_CASE("Thread pool") {
+  test("Destroying the pool runs every submitted task", [&] {
+    std::atomic<std::size_t> num_runs = 0;
+    {
+      ThreadPool pool(3);
+      for (std::size_t i = 0; i < 100; ++i) {
+        pool.submit([&] {
+          num_runs += 1;
+        });
+      }
+    }
+    expect(num_runs.load(), isEqualTo(100));
+  });
+
+  test("Submitting from many threads while workers are awake", [&] {
+    constexpr std::size_t num_rounds = 20;
+    constexpr std::size_t num_submitters = 4;
+    constexpr std::size_t tasks_per_submitter = 2000;
+    std::atomic<std::size_t> num_runs = 0;
+    for (std::size_t round = 0; round < num_rounds; ++round) {
+      ThreadPool pool(4);
+      std::vector<std::thread> submitters;
+      for (std::size_t i = 0; i < num_submitters; ++i) {
+        submitters.emplace_back([&] {
+          for (std::size_t j = 0; j < tasks_per_submitter; ++j) {
+            pool.submit([&] {
+              num_runs += 1;
+            });
+          }
+        });
+      }
+      for (std::thread& submitter: submitters) {
+        submitter.join();
+      }
+    }
+    expect(num_runs.load(),
+           isEqualTo(num_rounds * num_submitters * tasks_per_submitter));
+  });
+}